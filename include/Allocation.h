@@ -1,15 +1,15 @@
 #ifndef ALLOCATION
 #define ALLOCATION
 
-#include <string>
-
 using namespace std;
 
 class Allocation
 {
 public:
-    string event_id;
-    string time_id;
+    static const int UNALLOCATED = -1;
+
+    int event_id; // índice em Instance::events
+    int time_id;  // índice em Instance::times
     int duration;
 };
 
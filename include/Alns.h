@@ -0,0 +1,88 @@
+#ifndef ALNS
+#define ALNS
+
+#include "Instance.h"
+#include "Solution.h"
+#include "IncrementalEvaluator.h"
+#include "Greedy.h"
+#include "StopCriteria.h"
+#include "RngStream.h"
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Adaptive Large Neighborhood Search: a cada iteração sorteia um operador de destruição e um
+// de reparo (roleta pelos pesos), aplica os dois na solução corrente e decide pelo recozimento
+// simulado. Os pesos se ajustam a cada segmento conforme o sucesso de cada operador.
+class Alns
+{
+public:
+    // Escolhe até count eventos para remover (sem repetição); o avaliador reflete a solução
+    using DestroyFunction = function<vector<int>(const Instance &, const Solution &, const IncrementalEvaluator &, int count, RngStream &)>;
+
+    // Realoca as aulas dos eventos destruídos; o avaliador já reflete a remoção
+    using RepairFunction = function<void(const Instance &, Solution &, IncrementalEvaluator &, vector<int> &destroyed, RngStream &)>;
+
+    class OperatorStats
+    {
+    public:
+        string name;
+        double weight = 1.0;
+        int uses = 0;
+        int accepted = 0;  // movimentos aceitos
+        int improved = 0;  // melhoraram a solução corrente
+        int new_best = 0;  // acharam uma nova melhor solução
+        double seconds = 0; // tempo gasto dentro do operador
+
+        double success_rate() const { return uses ? (double)improved / uses : 0.0; }
+    };
+
+    // Pontuações do segmento (Ropke e Pisinger): nova melhor, melhorou a corrente, piora aceita
+    double score_new_best = 33;
+    double score_improved = 9;
+    double score_accepted = 13;
+    double reaction = 0.1;     // quanto do peso é renovado ao fim de cada segmento
+    int segment_length = 100;  // iterações por segmento
+
+    // Registra os operadores padrão (ver register_default_operators); max_restarts limita o Greedy
+    // da solução inicial e o do reparo "greedy"
+    explicit Alns(RngStream rng = RngStream(), int max_restarts = Greedy::DEFAULT_MAX_RESTARTS);
+
+    void register_destroy(const string &name, DestroyFunction destroy);
+    void register_repair(const string &name, RepairFunction repair);
+
+    // Para após max_iters iterações (negativo = sem limite) ou quando stop indicar prazo/alvo.
+    // Em cada iteração são destruídos entre metade e destruction_percentage dos eventos.
+    Solution solve(Instance &instance, int max_iters, float destruction_percentage, StopCriteria stop = StopCriteria());
+
+    const vector<OperatorStats> &destroy_stats() const { return destroy_info; }
+    const vector<OperatorStats> &repair_stats() const { return repair_info; }
+
+    void print_statistics(ostream &out = cout) const;
+
+private:
+    RngStream rng;
+    int max_restarts;
+
+    vector<DestroyFunction> destroys;
+    vector<RepairFunction> repairs;
+    vector<OperatorStats> destroy_info;
+    vector<OperatorStats> repair_info;
+    vector<double> destroy_scores; // pontuação acumulada no segmento atual
+    vector<double> repair_scores;
+    vector<int> destroy_segment_uses;
+    vector<int> repair_segment_uses;
+
+    void register_default_operators();
+
+    // Roleta pelos pesos
+    int select(const vector<OperatorStats> &operators);
+
+    void update_weights(vector<OperatorStats> &operators, vector<double> &scores, vector<int> &segment_uses);
+};
+
+#endif
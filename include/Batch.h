@@ -0,0 +1,77 @@
+#ifndef BATCH
+#define BATCH
+
+#include "Instance.h"
+#include "Solution.h"
+#include "Greedy.h"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+// Uma configuração de execução: algoritmo, parâmetros e semente
+class BatchConfig
+{
+public:
+    string algorithm = "ig"; // "ig", "ig_parallel", "abc", "islands", "alns", "tabu" ou "sa"
+    int iterations = 200;    // iterações (IG/ALNS/tabu), ciclos (ABC/ilhas) ou movimentos (SA); negativo = sem limite
+    double destruction = 0.3;
+    int pop_size = 15;
+    int limit = 50;
+    int threads = 1;         // threads internas do solver (ig_parallel e abc) ou número de ilhas
+    int sync_interval = 20;  // iterações entre sincronizações (ig_parallel) ou ciclos entre migrações
+    double time_limit = -1;  // segundos por job; negativo = sem prazo
+    double target_cost = -1;
+    int restarts = Greedy::DEFAULT_MAX_RESTARTS; // reinícios do Greedy; negativo = sem limite
+    uint32_t seed = 1;
+
+    // Nome usado nos arquivos de saída (ex.: "ig_s3")
+    string label() const;
+
+    // Lê um arquivo com uma configuração por linha, no formato
+    //   <algoritmo> [chave=valor ...]
+    // com chaves iterations, destruction, pop, limit, threads, sync, time, target, restarts, seed e
+    // seeds=a-b (uma configuração por semente, a <= b). Linhas vazias e iniciadas por '#' são
+    // ignoradas; linhas com algoritmo desconhecido, opção malformada ou desconhecida ou valor inválido são
+    // descartadas com um aviso.
+    static vector<BatchConfig> parse_file(const string &path);
+};
+
+class BatchResult
+{
+public:
+    string instance;
+    string config;
+    uint32_t seed = 0;
+    int hard_violations = 0;
+    int soft_violations = 0;
+    int total_cost = 0;
+    double seconds = 0;
+    string solution_path;
+    bool failed = false; // instância não carregou ou erro de gravação: o job fica fora do results.csv
+};
+
+// Executa todas as combinações instância x configuração num único pool de threads
+class Batch
+{
+public:
+    // Grava a solução de cada job em output_dir e um results.csv com uma linha por job,
+    // na ordem (instância, configuração), independente da ordem de execução. Jobs de instâncias
+    // que não carregaram, ou cujo nome de arquivo repete o de uma instância anterior, voltam com
+    // failed e não geram arquivos; erros ao criar output_dir ou gravar os arquivos também marcam
+    // os jobs afetados com failed. Jobs simultâneos x threads de cada job ficam em num_threads,
+    // exceto quando as ilhas/cadeias de uma configuração sozinhas passam disso.
+    static vector<BatchResult> run(const vector<string> &instance_paths, const vector<BatchConfig> &configs,
+                                   int num_threads, const string &output_dir);
+
+private:
+    // Threads que o job usa: as do ABC limitadas a num_threads, as ilhas ou cadeias da configuração,
+    // ou 1 para os solvers sequenciais
+    static int job_threads(const BatchConfig &config, int num_threads);
+
+    static Solution solve(Instance &instance, const BatchConfig &config, int threads);
+};
+
+#endif
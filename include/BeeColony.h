@@ -4,8 +4,16 @@
 #include "Instance.h"
 #include "Solution.h"
 #include "Evaluator.h"
+#include "IncrementalEvaluator.h"
 #include "Greedy.h"
 #include "IteratedGreedy.h"
+#include "LocalSearch.h"
+#include "VisitedSet.h"
+#include "ThreadPool.h"
+#include "StopCriteria.h"
+#include "RngStream.h"
+
+#include <functional>
 
 class BeeColony {
 private:
@@ -14,29 +22,79 @@ private:
     int limit; // Limite de tentativas antes do abandono
     int max_cycles; // Número máximo de ciclos
     double destruction_rate; // Taxa de destruição para perturbação
+    int num_threads; // Threads usadas nas fases das abelhas
 
     vector<Solution> population;
     vector<int> trial_counters;
     vector<double> fitness;
     vector<double> costs;
+    vector<IncrementalEvaluator> evaluators; // avaliação incremental de cada fonte de alimento
+    // Um Greedy (com seu fluxo aleatório) por fonte de alimento e por observadora, para que
+    // o resultado não dependa de qual thread executa cada tarefa
+    vector<Greedy> source_greedies;
+    vector<Greedy> onlooker_greedies;
+    RngStream rng; // sorteio das observadoras, feito na thread principal
+    int max_restarts; // limite de reinícios dos Greedy de cada fonte e observadora
+    StopCriteria stop; // prazo, custo alvo e callback da execução atual
     Solution best_solution;
     double best_cost;
 
-    // Função para avaliar uma solução
-    double evaluate(Solution& sol);
+    // Função para avaliar por completo a fonte de alimento i
+    double evaluate(int i);
 
     // Função para destruir eventos aleatoriamente
-    pair<Solution, vector<string>> destroy_random(Solution solution, int num_events);
+    pair<Solution, vector<int>> destroy_random(const Solution &solution, int num_events, RngStream &rng);
+
+    // Reconstruções já avaliadas, pelo hash logo após o rebuild.
+    // Lido pelas threads durante as fases e gravado só na thread principal.
+    VisitedSet visited;
+
+    // Função para perturbar uma solução; devolve também os eventos realocados.
+    // evaluator chega com a avaliação de sol e sai com a da solução perturbada, exceto se a
+    // reconstrução já tiver sido vista (revisited), quando a avaliação é pulada.
+    pair<Solution, vector<int>> perturb_solution(const Solution &sol, Greedy &greedy, IncrementalEvaluator &evaluator,
+                                                 uint64_t &rebuilt_hash, bool &revisited);
 
-    // Função para perturbar uma solução
-    Solution perturb_solution(Solution sol);
+    // Alguma fonte da população tem exatamente essas aulas
+    bool is_duplicate(uint64_t hash) const;
+
+    // Aceita o candidato para a fonte i se ele for melhor
+    void merge_candidate(int i, Solution &candidate, IncrementalEvaluator &candidate_evaluator, double candidate_cost);
+
+    // Atualiza a melhor solução com a fonte i, se ela for melhor
+    void update_best(int i);
 
 public:
-    BeeColony(Instance& inst);
+    BeeColony(Instance& inst, int num_threads = 1, RngStream rng = RngStream(), int max_restarts = Greedy::DEFAULT_MAX_RESTARTS);
+
+    // Recomeça os fluxos a partir da semente mestre, para repetir uma execução
+    void seed(uint64_t value);
 
-    void solve(int pop_size, int limit, int max_cycles, double destruction_rate);
+    // Mostra o progresso a cada 10 ciclos
+    bool verbose = true;
+
+    // Busca local aplicada a cada solução perturbada (compartilhada entre as threads, só leitura)
+    LocalSearch local_search;
+    bool use_local_search = true;
+
+    // Para após max_cycles ciclos (negativo = sem limite) ou quando stop indicar prazo/alvo atingido.
+    // O prazo é verificado entre as fases, então um ciclo em andamento termina a fase atual.
+    void solve(int pop_size, int limit, int max_cycles, double destruction_rate, StopCriteria stop = StopCriteria());
+
+    // Chamado pela thread principal ao fim de cada ciclo; devolver false encerra a execução
+    function<bool(int cycle)> on_cycle;
+
+    // As count melhores fontes de alimento, da melhor para a pior
+    vector<Solution> best_sources(int count) const;
+
+    // Recebe uma solução de fora (ex.: migração): substitui a pior fonte se for melhor que ela
+    // e não repetir uma fonte da população.
+    // Devolve true se a solução entrou na população.
+    bool immigrate(const Solution &solution);
 
     Solution getBestSolution();
+
+    double getBestCost() const { return best_cost; }
 };
 
 #endif
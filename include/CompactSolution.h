@@ -0,0 +1,58 @@
+#ifndef COMPACTSOLUTION
+#define COMPACTSOLUTION
+
+#include "Instance.h"
+#include "Solution.h"
+
+#include <cstdint>
+#include <type_traits>
+
+using namespace std;
+
+// Representação canônica e compacta de uma solução: um vetor fixo de aulas (evento, início,
+// duração) ordenado, mais as máscaras de ocupação de professores e turmas derivadas dele.
+// Não tem ponteiros: copia com memcpy, compara pelos bytes das aulas e cabe em poucos KB.
+// A Solution completa (com as estruturas derivadas) é remontada por expand.
+class CompactSolution
+{
+public:
+    static const int MAX_LESSONS = 512;
+    static const int MAX_TEACHERS = 64;
+    static const int MAX_CLASSES = 64;
+    static const uint8_t UNALLOCATED = 0xFF;
+
+    class Lesson
+    {
+    public:
+        uint16_t event_id;
+        uint8_t time_id; // UNALLOCATED para aula não alocada
+        uint8_t duration;
+    };
+
+    uint16_t num_lessons = 0;
+    uint16_t num_teachers = 0;
+    uint16_t num_classes = 0;
+    uint64_t hash = 0;                   // mesmo hash de Zobrist de Solution::hash
+    Lesson lessons[MAX_LESSONS];         // ordenadas por (evento, horário, duração)
+    uint64_t teacher_busy[MAX_TEACHERS]; // teacher -> horários ocupados
+    uint64_t class_busy[MAX_CLASSES];    // class -> horários ocupados
+
+    // A instância cabe nos limites fixos (e os índices, nos campos de Lesson)
+    static bool fits(const Instance &instance);
+
+    // Devolve false se a solução não couber (aulas demais ou instância grande demais)
+    bool assign(const Instance &instance, const Solution &solution);
+
+    Solution expand(const Instance &instance) const;
+
+    // Mesmas aulas; as máscaras e o hash derivam delas
+    bool operator==(const CompactSolution &other) const;
+    bool operator!=(const CompactSolution &other) const { return !(*this == other); }
+
+    // Bytes usados de fato: cabeçalho e aulas preenchidas, sem as máscaras (que expand não precisa)
+    size_t used_bytes() const;
+};
+
+static_assert(is_trivially_copyable<CompactSolution>::value, "CompactSolution deve copiar com memcpy");
+
+#endif
@@ -2,24 +2,67 @@
 #define CONSTRAINTINFO
 
 #include <string>
-#include <unordered_set>
+#include <vector>
 
 using namespace std;
 
 class ConstraintInfo
 {
 public:
-    string type;
-    bool required;
-    int weight;
-    unordered_set<string> applies_to_events;
-    unordered_set<string> applies_to_teachers;
-    unordered_set<string> applies_to_classes;
-    unordered_set<string> applies_to_times;
-    int min_value;
-    int max_value;
-    int duration_constraint;
-    unordered_set<string> time_groups;
+    enum Type
+    {
+        ASSIGN_TIME,
+        SPLIT_EVENTS,
+        DISTRIBUTE_SPLIT_EVENTS,
+        PREFER_TIMES,
+        SPREAD_EVENTS,
+        AVOID_CLASHES,
+        AVOID_UNAVAILABLE_TIMES,
+        LIMIT_IDLE_TIMES,
+        CLUSTER_BUSY_TIMES,
+        UNKNOWN // também é o número de tipos conhecidos
+    };
+
+    // Peso de cada violação de restrição obrigatória no objetivo
+    static const int HARD_WEIGHT = 1000;
+
+    Type type = UNKNOWN;
+    bool required = false;
+    int weight = 1;
+    vector<int> applies_to_courses;   // EventGroups que são cursos -> índices em Instance::courses
+    vector<int> applies_to_teachers;  // índices em Instance::teachers
+    vector<string> applies_to_groups; // ResourceGroups (ex.: gr_Teachers)
+    vector<int> applies_to_times;     // índices em Instance::times
+    int min_value = 0;
+    int max_value = 0;
+    int duration_constraint = 0;
+
+    // Nome do elemento XML do tipo (ex.: "ClusterBusyTimesConstraint"); "?" para UNKNOWN
+    static const char *type_name(Type type)
+    {
+        static const char *const names[UNKNOWN] = {
+            "AssignTimeConstraint",
+            "SplitEventsConstraint",
+            "DistributeSplitEventsConstraint",
+            "PreferTimesConstraint",
+            "SpreadEventsConstraint",
+            "AvoidClashesConstraint",
+            "AvoidUnavailableTimesConstraint",
+            "LimitIdleTimesConstraint",
+            "ClusterBusyTimesConstraint"};
+        return type >= 0 && type < UNKNOWN ? names[type] : "?";
+    }
+
+    // Converte o nome do elemento XML (inverso de type_name)
+    static Type parse_type(const string &name)
+    {
+        for (int type = 0; type < UNKNOWN; type++)
+        {
+            if (name == type_name((Type)type))
+                return (Type)type;
+        }
+        return UNKNOWN;
+    }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -4,18 +4,59 @@
 #include "Instance.h"
 #include "Solution.h"
 
+#include <vector>
+
+using namespace std;
+
 class Evaluator
 {
+public:
+    // Uma violação e as entidades envolvidas (-1 quando não se aplica)
+    class Violation
+    {
+    public:
+        ConstraintInfo::Type type;
+        int constraint_index = -1; // restrição de origem em Instance::constraints
+        int count = 1;             // violações (ex.: aulas excedentes num choque)
+        int cost = 0;              // custo ponderado; hard conta HARD_WEIGHT por violação
+        int event_id = -1;
+        int teacher_id = -1;
+        int class_id = -1;
+        int time_id = -1;
+        int day = -1;
+    };
+
 private:
     void check_hard_constraints(const Instance &instance, const Solution &solution);
     void check_soft_constraints(const Instance &instance, const Solution &solution);
 
+    // Registra a violação nos totais e nos custos por entidade
+    void add(const Violation &violation);
+
+    // Eventos do professor (ou turma) com aula cobrindo o horário
+    static vector<int> events_at(const Instance &instance, const Solution &solution, const vector<int> &events, int time_id);
+
 public:
     int hard_violations = 0;
     int soft_violations = 0;
     int total_cost = 0;
 
+    // Por tipo de restrição (índice ConstraintInfo::Type)
+    int type_violations[ConstraintInfo::UNKNOWN] = {};
+    int type_costs[ConstraintInfo::UNKNOWN] = {};
+
+    vector<Violation> violations;
+
+    // Custo das violações em que cada entidade está envolvida. Um choque conta para todos os
+    // eventos envolvidos, então a soma por entidade pode passar do custo total.
+    vector<int> event_costs;
+    vector<int> teacher_costs;
+    vector<int> class_costs;
+
+    static bool is_hard(ConstraintInfo::Type type);
+
     void evaluate(const Instance &instance, const Solution &solution);
+
     void print_report() const;
 };
 
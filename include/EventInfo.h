@@ -9,10 +9,11 @@ class EventInfo
 {
 public:
     string id;
-    int total_duration;
-    string course_id;
-    string teacher_id;
-    string class_id;
+    int index;
+    int total_duration = 0;
+    int course_id = -1;  // índice em Instance::courses
+    int teacher_id = -1; // índice em Instance::teachers
+    int class_id = -1;   // índice em Instance::classes
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -3,13 +3,34 @@
 
 #include "Instance.h"
 #include "Solution.h"
+#include "RngStream.h"
 
 class Greedy
 {
+private:
+    // Sorteia um dos candidate_times, ou -1 se não houver
+    int pick_time(const Instance &instance, const Solution &solution, const EventInfo &event, int duration, RngStream &rng);
+
+    // Registra a duração que sobrou de cada evento como aula não alocada
+    void mark_unassigned(const Instance &instance, Solution &solution, const vector<int> &remaining_duration);
+
 public:
+    static constexpr int DEFAULT_MAX_RESTARTS = 100;
+
+    // Horários (bits) em que a aula do evento cabe sem choque, fora dos dias em que ele já tem aula
+    static uint64_t candidate_times(const Instance &instance, const Solution &solution, const EventInfo &event, int duration);
+
+    // Reinícios permitidos antes de devolver a melhor solução parcial; negativo = sem limite
+    int max_restarts;
+
+    // Fluxo aleatório próprio de cada Greedy (um por thread/tarefa)
+    RngStream rng;
+
+    Greedy(int max_restarts = DEFAULT_MAX_RESTARTS, RngStream rng = RngStream()) : max_restarts(max_restarts), rng(rng) {}
+
     Solution generate_greedy(const Instance &instance);
 
-    void generate_greedy(vector<string> destroyed_events, Solution &solution, Instance &instance);
+    void generate_greedy(vector<int> destroyed_events, Solution &solution, const Instance &instance);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef INCREMENTALEVALUATOR
+#define INCREMENTALEVALUATOR
+
+#include "Instance.h"
+#include "Solution.h"
+
+// Avaliação incremental: guarda a contribuição de cada evento e professor e,
+// a cada movimento, recalcula apenas as entidades tocadas. Segue as mesmas
+// regras do Evaluator; o estado deve acompanhar a solução passada aos métodos.
+class IncrementalEvaluator
+{
+public:
+    class Move
+    {
+    public:
+        enum Kind
+        {
+            INSERT,
+            REMOVE
+        };
+
+        Kind kind;
+        Allocation alloc;
+    };
+
+    static const int HARD_WEIGHT = ConstraintInfo::HARD_WEIGHT;
+
+    // Indexados por ConstraintInfo::Type, como os totais do Evaluator
+    int violations[ConstraintInfo::UNKNOWN] = {};
+    int costs[ConstraintInfo::UNKNOWN] = {};
+
+    IncrementalEvaluator(const Instance &instance);
+
+    // Avaliação completa da solução
+    void reset(const Solution &solution);
+
+    // Recalcula os eventos alterados externamente (ex.: destroy/rebuild) e seus professores
+    void rescore(const Solution &solution, const vector<int> &events);
+
+    int hard_violations() const;
+    int soft_violations() const;
+    int total_cost() const;
+    int objective() const; // hard * HARD_WEIGHT + custo soft
+
+    // Custo mantido de cada entidade (hard com peso HARD_WEIGHT): as restrições do evento mais as
+    // aulas dele em choque; a restrição de dias do professor e a de janelas num dia dele
+    int event_cost(const Solution &solution, int event_id) const;
+    int teacher_days_cost(int teacher_id) const;
+    int teacher_idle_cost(int teacher_id, int day) const;
+
+    int delta_insert(const Solution &solution, int event_id, int time_id, int duration) const;
+    int delta_remove(const Solution &solution, int event_id, int time_id, int duration) const;
+
+    void apply(Solution &solution, const Move &move);
+    void undo(Solution &solution, const Move &move);
+
+private:
+    const Instance *instance;
+
+    vector<int> event_assign;      // event -> violação de AssignTime
+    vector<int> event_unavailable; // event -> aulas em horários indisponíveis
+    vector<int> event_spread;      // event -> dias com mais de uma aula
+    vector<int> event_split;       // event -> violação de DistributeSplitEvents
+    vector<int> teacher_cluster;   // teacher -> violação de ClusterBusyTimes
+    vector<vector<int>> teacher_idle; // teacher -> day -> violação de LimitIdleTimes
+
+    int delta(const Solution &solution, int event_id, int time_id, int duration, int sign) const;
+
+    int split_violation(int event_id, int doubles) const;
+    int cluster_violation(int teacher_id, int days) const;
+    int idle_violation(const Solution &solution, int teacher_id, int day, int added_time, int removed_time) const;
+
+    void rescore_event(const Solution &solution, int event_id);
+    void rescore_teacher(const Solution &solution, int teacher_id);
+    void add(ConstraintInfo::Type type, int diff, int weight);
+};
+
+#endif
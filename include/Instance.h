@@ -1,7 +1,6 @@
 #ifndef INSTANCE
 #define INSTANCE
 
-#include "tinyxml2.h"
 #include "TimeInfo.h"
 #include "ResourceInfo.h"
 #include "EventInfo.h"
@@ -10,28 +9,78 @@
 #include <vector>
 #include <unordered_map>
 #include <algorithm>
+#include <cstdint>
+#include <istream>
 
 using namespace std;
-using namespace tinyxml2;
+
+class XmlReader;
 
 class Instance
 {
 public:
+    string id; // atributo Id do elemento <Instance>
     vector<TimeInfo> times;
     vector<ResourceInfo> resources;
     vector<EventInfo> events;
     vector<ConstraintInfo> constraints;
 
+    // Ids do XML de cada índice denso; só usados na importação/exportação
+    vector<string> days;
+    vector<string> teachers;
+    vector<string> classes;
+    vector<string> courses;
+
     unordered_map<string, int> time_index;
     unordered_map<string, int> event_index;
-    unordered_map<string, string> teacher_name;
+    unordered_map<string, int> day_index;
+    unordered_map<string, int> teacher_index;
+    unordered_map<string, int> class_index;
+    unordered_map<string, int> course_index;
+
+    vector<vector<int>> teacher_events; // teacher -> events
+    vector<vector<int>> class_events;   // class -> events
+
+    vector<vector<bool>> teacher_unavailable_times; // teacher -> time -> indisponível
+    vector<pair<int, int>> course_split_constraints; // course -> (min, max), (-1, -1) se não houver
+    vector<int> course_split_weight;                 // course -> peso da DistributeSplitEventsConstraint
+    vector<int> teacher_max_days;                    // teacher -> máximo de dias, -1 se não houver
+    vector<int> teacher_max_days_weight;             // teacher -> peso da ClusterBusyTimesConstraint
+    bool has_idle_constraint = false;
+    int idle_weight = 1;                             // peso da LimitIdleTimesConstraint
+    // Restrição de constraints que originou cada entrada das tabelas acima (-1 se nenhuma)
+    vector<int> type_source;                         // tipo -> primeira restrição do tipo
+    vector<vector<int>> teacher_unavailable_source;  // teacher -> time -> AvoidUnavailableTimesConstraint
+    vector<int> course_split_source;                 // course -> DistributeSplitEventsConstraint
+    vector<int> teacher_max_days_source;             // teacher -> ClusterBusyTimesConstraint
+    int idle_source = -1;                            // LimitIdleTimesConstraint de idle_weight
+    vector<int> next_time;                           // time -> próximo horário do dia, -1 se não houver
+    uint64_t double_starts = 0;                      // bits dos horários t que iniciam aula dupla em (t, t + 1)
+    vector<uint64_t> day_times;                      // day -> bits dos horários do dia
+    vector<uint64_t> event_single_times;             // event -> horários candidatos para aula simples
+    vector<uint64_t> event_double_times;             // event -> inícios candidatos para aula dupla
+
+    // Carrega o XML; com use_cache, usa/grava filename + ".cache" (ver InstanceCache). O cache é
+    // validado pelo hash do arquivo inteiro (mapeado com mmap); sem cache, a leitura é em fluxo.
+    // Devolve false (com a mensagem em cerr) se o arquivo não existir ou não for uma instância válida.
+    bool load(const string &filename, bool use_cache = true);
+
+    bool is_teacher_unavailable(int teacher_id, int time_id) const
+    {
+        return teacher_unavailable_times[teacher_id][time_id];
+    }
 
-    unordered_map<string, unordered_set<string>> teacher_unavailable_times;
-    unordered_map<string, pair<int, int>> course_split_constraints;
-    unordered_map<string, int> teacher_max_days;
-    unordered_map<string, string> next_time;
+private:
+    // Interpreta o XML já lido, em fluxo (sem DOM); false se o arquivo for inválido
+    bool parse(istream &in, const string &filename);
+    bool parse_instance(XmlReader &reader);
+    bool parse_times(XmlReader &reader);
+    void parse_resources(XmlReader &reader);
+    void parse_events(XmlReader &reader);
+    void parse_constraints(XmlReader &reader);
 
-    void load(const string &filename);
+    // Monta as tabelas densas (restrições compiladas, next_time, máscaras) após a leitura
+    void compile_tables();
 };
 
 #endif
@@ -0,0 +1,30 @@
+#ifndef INSTANCECACHE
+#define INSTANCECACHE
+
+#include "Instance.h"
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+// Cache binário de uma Instance já compilada (tabelas densas + tabela de strings).
+// O arquivo guarda o hash do XML de origem; se o XML mudar, o cache é ignorado e regravado.
+class InstanceCache
+{
+public:
+    static const uint32_t VERSION = 4;
+
+    // Hash FNV-1a de 64 bits do conteúdo do XML
+    static uint64_t hash(const char *data, size_t size);
+
+    // Mapeia o arquivo em memória e preenche a instância; false se ausente, inválido ou de outro XML.
+    // As tabelas são copiadas para os vetores da Instance, e o mapeamento é desfeito ao final.
+    static bool read(const string &path, uint64_t source_hash, Instance &instance);
+
+    // Grava o cache (em um arquivo temporário renomeado no fim, seguro com vários processos)
+    static bool write(const string &path, uint64_t source_hash, const Instance &instance);
+};
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef ISLANDMODEL
+#define ISLANDMODEL
+
+#include "Instance.h"
+#include "Solution.h"
+#include "BeeColony.h"
+#include "StopCriteria.h"
+#include "RngStream.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+// Modelo de ilhas: várias colônias (BeeColony, uma thread cada) evoluem separadas e, a cada
+// migration_interval ciclos, mandam suas migrants melhores fontes de alimento para as vizinhas da
+// topologia. As soluções viajam como bytes de CompactSolution (encode/decode) por caixas de mensagens, uma
+// por ilha; não há trava global. A ilha espera as mensagens da mesma época das vizinhas, então o
+// resultado é reprodutível pela semente; uma vizinha que terminou deixa de ser esperada.
+class IslandModel
+{
+public:
+    enum Topology
+    {
+        RING,           // ilha i manda para i + 1
+        FULLY_CONNECTED // cada ilha manda para todas as outras
+    };
+
+    int migration_interval = 10; // ciclos entre migrações
+    int migrants = 1;            // fontes enviadas por migração
+    Topology topology = RING;
+    bool verbose = true;         // mostra as melhoras globais
+
+    // A ilha i usa a semente rng.split(i); max_restarts vai para o BeeColony de cada ilha
+    IslandModel(Instance &instance, int num_islands, RngStream rng = RngStream(), int max_restarts = Greedy::DEFAULT_MAX_RESTARTS);
+
+    // Recomeça os fluxos a partir da semente mestre, para repetir uma execução
+    void seed(uint64_t value);
+
+    // Mesmos parâmetros do BeeColony::solve, por ilha. O prazo vale para todas; o custo alvo
+    // atingido por uma ilha encerra as outras no fim do ciclo. stop.on_improvement recebe só
+    // as melhoras globais, sob um mutex.
+    Solution solve(int pop_size, int limit, int max_cycles, double destruction_rate, StopCriteria stop = StopCriteria());
+
+    // Bytes da CompactSolution (cabeçalho e aulas usadas, na ordem de bytes da máquina).
+    // Vazio se a solução não couber numa CompactSolution; a migração é então ignorada.
+    static vector<uint8_t> encode(const Instance &instance, const Solution &solution);
+
+    // Devolve false (e deixa solution indefinida) se os bytes não formarem uma solução da instância
+    static bool decode(const Instance &instance, const vector<uint8_t> &bytes, Solution &solution);
+
+private:
+    // Mensagem de uma migração: soluções codificadas enviadas por sender na época epoch
+    class Message
+    {
+    public:
+        int sender;
+        int epoch;
+        vector<vector<uint8_t>> solutions;
+    };
+
+    class Mailbox
+    {
+    public:
+        mutex mtx;
+        condition_variable arrived;
+        vector<Message> messages;
+        vector<bool> closed; // sender -> terminou, não mandará mais nada
+    };
+
+    Instance &instance;
+    int num_islands;
+    RngStream rng;
+    int max_restarts;
+
+    // Ilhas que recebem as migrações de island
+    vector<int> neighbors(int island) const;
+};
+
+#endif
@@ -4,21 +4,56 @@
 #include "Instance.h"
 #include "Solution.h"
 #include "Evaluator.h"
+#include "IncrementalEvaluator.h"
 #include "Greedy.h"
+#include "LocalSearch.h"
+#include "VisitedSet.h"
+#include "StopCriteria.h"
 
 class IteratedGreedy
 {
 private:
-    vector<string> select_events(const Solution& solution, const Instance& instance, int num_events);
+    Greedy greedy;
+    RngStream rng; // critério de aceitação; as cadeias paralelas usam fluxos derivados dele
 
-    pair<Solution, vector<string>> destroy(Solution solution, int destruction_rate, const Instance &instance);
+    // Reconstruções já avaliadas, pelo hash logo após o rebuild; uma reconstrução repetida é
+    // rejeitada sem avaliar (como numa lista tabu de soluções)
+    VisitedSet visited;
 
-    Solution rebuild(Solution solution, vector<string> &destroyed, Instance &instance);
+    // destroy e rebuild alteram a solução no lugar; com uma transação aberta, rollback desfaz os dois.
+    // evaluator deve refletir a solução antes da destruição.
+    vector<int> destroy(Solution &solution, const IncrementalEvaluator &evaluator, int destruction_rate, const Instance &instance);
+
+    void rebuild(Solution &solution, vector<int> &destroyed, Instance &instance);
 
 public:
-    void remove_allocations(string event_id, Solution &solution, const Instance &instance);
+    // Os num_events eventos com maior custo no IncrementalEvaluator da solução (as violações de
+    // professor contam para os eventos dele envolvidos)
+    static vector<int> select_events(const Solution &solution, const Instance &instance, const IncrementalEvaluator &evaluator,
+                                     int num_events);
+
+    // Busca local aplicada depois de cada reconstrução
+    LocalSearch local_search;
+    bool use_local_search = true;
+
+    // O Greedy usa rng.split(0) e a aceitação, o próprio rng; max_restarts vai para o Greedy
+    explicit IteratedGreedy(RngStream rng = RngStream(), int max_restarts = Greedy::DEFAULT_MAX_RESTARTS)
+        : greedy(max_restarts, rng.split(0)), rng(rng) {}
+
+    // Recomeça os fluxos a partir da semente mestre, para repetir uma execução
+    void seed(uint64_t value);
+
+    static void remove_allocations(int event_id, Solution &solution, const Instance &instance);
+
+    // Para após max_iters iterações (negativo = sem limite) ou quando stop indicar prazo/alvo atingido
+    Solution solve(Instance &instance, int max_iters, float destruction_percentage, StopCriteria stop = StopCriteria());
 
-    Solution solve(Instance &instance, int max_iters, float destruction_percentage);
+    // Iterated Greedy com num_threads cadeias independentes que compartilham a melhor solução.
+    // A cada sync_interval iterações, cada cadeia recomeça da incumbente se ela for melhor.
+    // stop.on_improvement é chamado sob o mutex da incumbente, a partir da thread que achou a melhora,
+    // e por isso vê os custos sempre decrescentes.
+    Solution solve_parallel(Instance &instance, int max_iters, float destruction_percentage, int num_threads, int sync_interval,
+                            StopCriteria stop = StopCriteria());
 };
 
 
@@ -0,0 +1,99 @@
+#ifndef LOCALSEARCH
+#define LOCALSEARCH
+
+#include "Instance.h"
+#include "Solution.h"
+#include "IncrementalEvaluator.h"
+#include "RngStream.h"
+
+#include <vector>
+
+using namespace std;
+
+// Busca local de intensificação após o reparo. Vizinhanças, sempre com primeira melhora:
+//  - realocação: move uma aula para o horário livre de menor delta;
+//  - troca: duas aulas da mesma turma (mesma duração) trocam de horário;
+//  - cadeia de Kempe: entre dois horários t1 e t2, troca de lado todas as aulas simples ligadas
+//    à aula escolhida por professor ou turma, o que não cria choques novos.
+// Os destinos da realocação são avaliados com delta_insert, sem alterar a solução; trocas e
+// cadeias são aplicadas e, se rejeitadas, desfeitas com Solution::rollback_to, então só os
+// movimentos aceitos ficam no diário. Uma transação aberta na solução também desfaz a busca local.
+class LocalSearch
+{
+public:
+    int max_passes = 3;    // passadas pelas três vizinhanças; para antes se uma passada não melhorar
+    int kempe_tries = 200; // cadeias de Kempe sorteadas por passada
+
+    // Melhora a solução até um ótimo local (ou max_passes) e devolve a queda do objetivo.
+    // Se touched não for nulo, recebe os eventos alterados por movimentos aceitos.
+    int improve(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator, RngStream &rng,
+                vector<int> *touched = nullptr) const;
+
+    int relocate_pass(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator, RngStream &rng,
+                      vector<int> *touched = nullptr) const;
+    int swap_pass(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator, RngStream &rng,
+                  vector<int> *touched = nullptr) const;
+    int kempe_pass(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator, RngStream &rng,
+                   vector<int> *touched = nullptr) const;
+
+    // As aulas a e b (alocadas, de eventos diferentes e mesma duração) podem trocar de horário
+    static bool swappable(const Instance &instance, const Allocation &a, const Allocation &b);
+
+    // Troca as aulas from por to e mede a variação do objetivo (delta). Se accept(delta) for
+    // falso, desfaz: numa transação aberta, com rollback_to, sem deixar a tentativa no diário.
+    // Os eventos de from e to devem ser os mesmos (só os horários mudam).
+    template <class Accept>
+    static bool exchange(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator,
+                         const vector<Allocation> &from, const vector<Allocation> &to, Accept accept, int &delta)
+    {
+        // Uma reavaliação dos eventos no fim, em vez de uma por aula
+        vector<int> events;
+        for (const Allocation &alloc : from)
+        {
+            events.push_back(alloc.event_id);
+        }
+
+        size_t mark = solution.journal.size();
+        int before = evaluator.objective();
+        for (const Allocation &alloc : from)
+        {
+            solution.remove_allocation(instance, alloc);
+        }
+        for (const Allocation &alloc : to)
+        {
+            solution.add_allocation(instance, alloc);
+        }
+        evaluator.rescore(solution, events);
+
+        delta = evaluator.objective() - before;
+        if (accept(delta))
+            return true;
+
+        if (solution.journaling)
+            solution.rollback_to(instance, mark);
+        else
+        {
+            for (const Allocation &alloc : to)
+            {
+                solution.remove_allocation(instance, alloc);
+            }
+            for (const Allocation &alloc : from)
+            {
+                solution.add_allocation(instance, alloc);
+            }
+        }
+        evaluator.rescore(solution, events);
+        return false;
+    }
+
+private:
+    // Aulas simples nos horários t1/t2 ligadas a start por professor ou turma; vazio se a cadeia
+    // encostar numa aula dupla ou levar um evento para um horário que ele não aceita
+    static vector<Allocation> kempe_chain(const Instance &instance, const Solution &solution, const Allocation &start, int other_time);
+
+    // exchange que só mantém a troca se o objetivo cair. Devolve a queda (ou 0).
+    static int try_exchange(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator,
+                            const vector<Allocation> &from, const vector<Allocation> &to, vector<int> *touched);
+};
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef OCCUPANCY
+#define OCCUPANCY
+
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+// Ocupação dos professores e turmas como máscaras de bits (um bit por horário).
+// As cargas por (recurso, horário) permitem remover aulas mesmo com choques.
+class Occupancy
+{
+public:
+    static const int MAX_TIMES = 64;
+
+    vector<uint64_t> teacher_busy; // teacher -> horários ocupados
+    vector<uint64_t> class_busy;   // class -> horários ocupados
+    vector<unsigned char> teacher_load; // teacher * num_times + time -> aulas
+    vector<unsigned char> class_load;   // class * num_times + time -> aulas
+    int num_times = 0;
+    int clashes = 0; // aulas excedentes somadas em todos os (recurso, horário)
+
+    Occupancy() {}
+
+    Occupancy(int num_teachers, int num_classes, int num_times)
+        : teacher_busy(num_teachers, 0),
+          class_busy(num_classes, 0),
+          teacher_load(num_teachers * num_times, 0),
+          class_load(num_classes * num_times, 0),
+          num_times(num_times)
+    {
+    }
+
+    uint64_t all_times() const
+    {
+        return num_times == MAX_TIMES ? ~0ULL : (1ULL << num_times) - 1;
+    }
+
+    void add(int teacher, int class_id, int time)
+    {
+        uint64_t bit = 1ULL << time;
+
+        if (teacher_load[teacher * num_times + time]++ > 0)
+            clashes++;
+        teacher_busy[teacher] |= bit;
+
+        if (class_load[class_id * num_times + time]++ > 0)
+            clashes++;
+        class_busy[class_id] |= bit;
+    }
+
+    void remove(int teacher, int class_id, int time)
+    {
+        uint64_t bit = 1ULL << time;
+
+        if (--teacher_load[teacher * num_times + time] > 0)
+            clashes--;
+        else
+            teacher_busy[teacher] &= ~bit;
+
+        if (--class_load[class_id * num_times + time] > 0)
+            clashes--;
+        else
+            class_busy[class_id] &= ~bit;
+    }
+
+    int teacher_count(int teacher, int time) const
+    {
+        return teacher_load[teacher * num_times + time];
+    }
+
+    int class_count(int class_id, int time) const
+    {
+        return class_load[class_id * num_times + time];
+    }
+
+    bool is_teacher_free(int teacher, int time) const
+    {
+        return !(teacher_busy[teacher] >> time & 1);
+    }
+
+    bool is_class_free(int class_id, int time) const
+    {
+        return !(class_busy[class_id] >> time & 1);
+    }
+
+    bool is_free(int teacher, int class_id, int time) const
+    {
+        return !((teacher_busy[teacher] | class_busy[class_id]) >> time & 1);
+    }
+
+    // Horários em que professor e turma estão livres
+    uint64_t free_times(int teacher, int class_id) const
+    {
+        return ~(teacher_busy[teacher] | class_busy[class_id]) & all_times();
+    }
+
+    // Inícios de aula dupla (t, t + 1) livres, restritos a double_starts
+    uint64_t free_double_starts(int teacher, int class_id, uint64_t double_starts) const
+    {
+        uint64_t free = free_times(teacher, class_id);
+        return free & (free >> 1) & double_starts;
+    }
+};
+
+#endif
@@ -11,6 +11,7 @@ public:
     string id;
     string name;
     string type; // "Teacher" ou "Class"
+    int index = -1; // índice em Instance::teachers ou Instance::classes
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,90 @@
+#ifndef RNGSTREAM
+#define RNGSTREAM
+
+#include <cstdint>
+#include <random>
+
+using namespace std;
+
+// Fluxo de números aleatórios reprodutível (xoshiro256**), usável com as distribuições e shuffle.
+// split(i) deriva um fluxo filho independente a partir da semente e de i, sem depender de quantos
+// números já foram sorteados: cada thread/tarefa recebe o seu e o resultado não depende do escalonamento.
+class RngStream
+{
+public:
+    using result_type = uint64_t;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    // Semente aleatória (random_device), para execuções não reprodutíveis
+    RngStream() : RngStream((uint64_t)random_device{}() << 32 | random_device{}()) {}
+
+    explicit RngStream(uint64_t seed) : seed_value(seed)
+    {
+        uint64_t x = seed;
+        for (uint64_t &s : state)
+        {
+            s = splitmix64(x);
+        }
+    }
+
+    result_type operator()()
+    {
+        uint64_t result = rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // Fluxo filho número index
+    RngStream split(uint64_t index) const
+    {
+        uint64_t x = seed_value ^ (index + 1) * 0x9E3779B97F4A7C15ULL;
+        splitmix64(x);
+        return RngStream(splitmix64(x));
+    }
+
+    // Real uniforme em [0, 1)
+    double uniform()
+    {
+        return ((*this)() >> 11) * 0x1.0p-53;
+    }
+
+    // Índice de um bit sorteado de mask (mask != 0), com a mesma chance para cada bit ligado
+    int pick_bit(uint64_t mask)
+    {
+        int skip = uniform_int_distribution<int>(0, __builtin_popcountll(mask) - 1)(*this);
+        while (skip-- > 0)
+        {
+            mask &= mask - 1;
+        }
+        return __builtin_ctzll(mask);
+    }
+
+    uint64_t seed() const { return seed_value; }
+
+private:
+    uint64_t seed_value;
+    uint64_t state[4];
+
+    static uint64_t rotl(uint64_t x, int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    static uint64_t splitmix64(uint64_t &x)
+    {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+};
+
+#endif
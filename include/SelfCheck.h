@@ -0,0 +1,55 @@
+#ifndef SELFCHECK
+#define SELFCHECK
+
+#include "Instance.h"
+#include "Solution.h"
+#include "IncrementalEvaluator.h"
+#include "RngStream.h"
+
+#include <string>
+#include <cstdint>
+
+using namespace std;
+
+// Verificação de consistência (tf --selfcheck): passeio aleatório de inserções e remoções sobre uma
+// instância, conferindo a cada movimento o delta previsto pelo IncrementalEvaluator com a mudança
+// real do objetivo e, periodicamente, o estado mantido com uma avaliação completa do Evaluator.
+// Parte dos movimentos roda em transações desfeitas (rollback_to/rollback), e a solução tem de
+// voltar bit a bit ao estado anterior e coincidir com uma Solution remontada das suas aulas.
+class SelfCheck
+{
+public:
+    int moves = 20000;       // movimentos do passeio aleatório
+    int full_interval = 100; // movimentos entre comparações com o Evaluator
+    int transaction_interval = 50; // movimentos entre transações desfeitas
+    int transaction_moves = 20;    // movimentos máximos em cada metade de uma transação
+
+    explicit SelfCheck(RngStream rng = RngStream(1)) : rng(rng) {}
+
+    // Devolve false (com a primeira divergência em cerr) se alguma verificação falhar
+    bool run(const Instance &instance, const string &name);
+
+private:
+    RngStream rng;
+    int total_duration = 0; // soma das durações dos eventos da instância atual
+
+    // Insere ou remove uma aula sorteada e confere o delta previsto; false se divergir
+    bool random_move(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator, const string &where);
+
+    // Abre uma transação, faz movimentos, volta até uma marca no meio e depois desfaz (ou confirma)
+    // o resto, conferindo a solução e o avaliador em cada ponto
+    bool random_transaction(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator, const string &where);
+
+    // Aulas ordenadas, para comparar soluções independentemente da ordem de allocations
+    static vector<Allocation> sorted_lessons(const vector<Allocation> &allocations);
+
+    // A solução tem as aulas e o hash do retrato e as estruturas derivadas de uma Solution remontada
+    static bool matches_rebuild(const Instance &instance, const Solution &solution, const vector<Allocation> &lessons,
+                                uint64_t hash, const string &where);
+
+    // Compara o IncrementalEvaluator com uma avaliação completa
+    static bool matches_evaluator(const Instance &instance, const Solution &solution, const IncrementalEvaluator &evaluator,
+                                  const string &where);
+};
+
+#endif
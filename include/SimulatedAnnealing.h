@@ -0,0 +1,66 @@
+#ifndef SIMULATEDANNEALING
+#define SIMULATEDANNEALING
+
+#include "Instance.h"
+#include "Solution.h"
+#include "IncrementalEvaluator.h"
+#include "Greedy.h"
+#include "StopCriteria.h"
+#include "RngStream.h"
+
+using namespace std;
+
+// Recozimento simulado sobre movimentos baratos: realocar uma aula para outro horário aceito pelo
+// evento ou trocar o horário de duas aulas da mesma turma, avaliados por delta e aceitos contra o
+// custo corrente. A temperatura inicial é calibrada pelos deltas de movimentos sorteados, o
+// resfriamento segue o relógio (ou o número de movimentos) e há reaquecimento na estagnação.
+class SimulatedAnnealing
+{
+public:
+    int calibration_samples = 500;   // movimentos sorteados para calibrar a temperatura inicial
+    double initial_acceptance = 0.5; // probabilidade de aceitar uma piora soft média no início
+    double final_ratio = 1e-4;       // temperatura final = final_ratio * inicial
+    double swap_probability = 0.2;   // fração dos movimentos que são trocas
+    long long reheat_after = 1000000; // movimentos sem nova melhor antes de reaquecer
+    double reheat_ratio = 0.3;       // reaquece para reheat_ratio * temperatura inicial
+    double cooling_rate = 0.99999;   // por movimento, só quando não há prazo nem max_moves
+
+    // O Greedy da solução inicial usa rng.split(0) e o limite de reinícios max_restarts
+    explicit SimulatedAnnealing(RngStream rng = RngStream(), int max_restarts = Greedy::DEFAULT_MAX_RESTARTS)
+        : rng(rng), greedy(max_restarts, rng.split(0)) {}
+
+    // Recomeça os fluxos a partir da semente mestre, para repetir uma execução
+    void seed(uint64_t value);
+
+    // Para após max_moves movimentos (negativo = sem limite) ou quando stop indicar prazo/alvo atingido.
+    // Com prazo, a temperatura cai pelo tempo decorrido; senão, pelos movimentos feitos.
+    Solution solve(Instance &instance, long long max_moves, StopCriteria stop = StopCriteria());
+
+    long long moves() const { return total_moves; }
+    long long accepted_moves() const { return total_accepted; }
+    int reheats() const { return total_reheats; }
+
+private:
+    RngStream rng;
+    Greedy greedy;
+
+    long long total_moves = 0;
+    long long total_accepted = 0;
+    int total_reheats = 0;
+
+    // Sorteia e avalia um movimento; aplica se accept(delta) for verdadeiro. Devolve o delta
+    // aplicado ou, se rejeitado/impossível, INT_MAX.
+    template <class Accept>
+    int try_move(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator, Accept accept);
+
+    template <class Accept>
+    int try_relocate(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator, Accept accept);
+
+    template <class Accept>
+    int try_swap(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator, Accept accept);
+
+    // Temperatura em que a piora média (só soft) dos movimentos sorteados é aceita com initial_acceptance
+    double calibrate(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator);
+};
+
+#endif
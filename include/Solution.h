@@ -2,6 +2,8 @@
 #define SOLUTION
 
 #include "Allocation.h"
+#include "Instance.h"
+#include "Occupancy.h"
 
 #include <vector>
 #include <unordered_map>
@@ -14,38 +16,118 @@ using namespace std;
 class Solution
 {
 public:
+    // Alteração registrada no diário (aula inserida ou removida)
+    class Change
+    {
+    public:
+        bool added;
+        Allocation alloc;
+    };
+
     vector<Allocation> allocations;
-    unordered_map<string, vector<Allocation>> event_allocations;
-    unordered_map<string, set<string>> teacher_schedule;
-    unordered_map<string, set<string>> class_schedule;
-    unordered_map<string, unordered_map<string, int>> event_day_counts;
-    unordered_map<string, int> event_double_lessons;
-    unordered_map<string, int> allocated_duration;
-    unordered_map<string, unordered_set<string>> teacher_occupation; // time_id -> teacher_ids
-    unordered_map<string, unordered_set<string>> class_occupation;   // time_id -> class_ids
-    
+    vector<vector<Allocation>> event_allocations;  // event -> alocações
+    vector<vector<int>> event_allocation_index;    // event -> posição em allocations de cada item de event_allocations
+    vector<set<int>> teacher_schedule;             // teacher -> dias
+    vector<set<int>> class_schedule;               // class -> dias
+    vector<vector<int>> teacher_day_lessons;       // teacher -> day -> aulas
+    vector<vector<int>> class_day_lessons;         // class -> day -> aulas
+    vector<vector<int>> event_day_counts;          // event -> day -> aulas
+    vector<int> event_double_lessons;              // event -> aulas duplas
+    vector<int> allocated_duration;                // event -> duração alocada
+    Occupancy occupancy;                           // teacher/class -> horários ocupados
+    vector<vector<uint64_t>> teacher_day_slots;    // teacher -> day -> bits dos slots (TimeInfo::slot) com início de aula
+    vector<vector<int>> teacher_time_starts;       // teacher -> time -> aulas iniciadas
+
+    // Hash de Zobrist das aulas (soma das chaves de cada evento/horário/duração), mantido por
+    // add/remove_allocation: soluções com as mesmas aulas têm o mesmo hash em qualquer ordem
+    uint64_t hash = 0;
+
+    // Diário de desfazer: enquanto journaling estiver ativo, add/remove registram cada alteração
+    vector<Change> journal;
+    bool journaling = false;
+
+    Solution() {}
+
+    explicit Solution(const Instance &instance)
+        : event_allocations(instance.events.size()),
+          event_allocation_index(instance.events.size()),
+          teacher_schedule(instance.teachers.size()),
+          class_schedule(instance.classes.size()),
+          teacher_day_lessons(instance.teachers.size(), vector<int>(instance.days.size(), 0)),
+          class_day_lessons(instance.classes.size(), vector<int>(instance.days.size(), 0)),
+          event_day_counts(instance.events.size(), vector<int>(instance.days.size(), 0)),
+          event_double_lessons(instance.events.size(), 0),
+          allocated_duration(instance.events.size(), 0),
+          occupancy(instance.teachers.size(), instance.classes.size(), instance.times.size()),
+          teacher_day_slots(instance.teachers.size(), vector<uint64_t>(instance.days.size(), 0)),
+          teacher_time_starts(instance.teachers.size(), vector<int>(instance.times.size(), 0))
+    {
+    }
+
+    // Chave pseudoaleatória da aula (splitmix64 do evento, horário e duração)
+    static uint64_t allocation_key(const Allocation &alloc)
+    {
+        uint64_t z = ((uint64_t)alloc.event_id << 32 | (uint64_t)(alloc.time_id + 1) << 16 | (uint64_t)alloc.duration) +
+                     0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // Há janela se os slots ocupados no dia não forem contíguos
+    static bool has_idle_gap(uint64_t slots)
+    {
+        if (slots == 0)
+            return false;
+        slots >>= __builtin_ctzll(slots);
+        return (slots & (slots + 1)) != 0;
+    }
+
+    // Insere uma aula e atualiza todas as estruturas derivadas. A aula é recebida por valor: pode
+    // vir de allocations ou event_allocations, que são alterados aqui.
+    void add_allocation(const Instance &instance, Allocation alloc);
+
+    // Remove uma aula (evento, horário, duração) e atualiza as estruturas derivadas.
+    // Custa O(aulas do evento): a ordem de allocations não é preservada (troca com a última).
+    // Por valor, como em add_allocation: a troca sobrescreve o elemento que foi passado.
+    bool remove_allocation(const Instance &instance, Allocation alloc);
+
+    // Abre uma transação: as alterações seguintes podem ser desfeitas com rollback
+    void begin_transaction();
+
+    // Confirma as alterações da transação e fecha o diário
+    void commit();
+
+    // Desfaz todas as alterações da transação e fecha o diário
+    void rollback(const Instance &instance);
+
+    // Desfaz as alterações feitas depois de journal[mark], mantendo a transação aberta
+    void rollback_to(const Instance &instance, size_t mark);
+
     void print(const Instance& instance) const {
         std::cout << "\n=== Detalhes da Solução ===\n";
         std::cout << "Alocações:\n";
         
         for (const auto& alloc : allocations) {
-            std::cout << "- Evento: " << alloc.event_id
-                      << " | Horário: " << alloc.time_id
+            std::cout << "- Evento: " << instance.events[alloc.event_id].id
+                      << " | Horário: " << (alloc.time_id == Allocation::UNALLOCATED ? string("UNALLOCATED") : instance.times[alloc.time_id].id)
                       << " | Duração: " << alloc.duration << "\n";
         }
 
         std::cout << "\nEventos não alocados:\n";
-        for (const auto& [event_id, duration] : allocated_duration) {
-            const EventInfo& event = instance.events[instance.event_index.at(event_id)];
+        for (const EventInfo& event : instance.events) {
+            int duration = allocated_duration[event.index];
             if (duration < event.total_duration) {
-                std::cout << "- " << event_id << ": " 
+                std::cout << "- " << event.id << ": " 
                           << duration << "/" << event.total_duration << " alocado\n";
             }
         }
 
         std::cout << "\nDias de trabalho por professor:\n";
-        for (const auto& [teacher, days] : teacher_schedule) {
-            std::cout << "- " << teacher << ": " << days.size() << " dias\n";
+        for (int teacher = 0; teacher < (int)teacher_schedule.size(); teacher++) {
+            if (teacher_schedule[teacher].empty())
+                continue;
+            std::cout << "- " << instance.teachers[teacher] << ": " << teacher_schedule[teacher].size() << " dias\n";
         }
     }
 };
@@ -0,0 +1,66 @@
+#ifndef SOLUTIONWRITER
+#define SOLUTIONWRITER
+
+#include "Instance.h"
+#include "Solution.h"
+#include "Allocation.h"
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Escreve soluções no formato XHSTT direto num buffer fixo, descarregado com write(2)
+// no descritor de arquivo. Várias soluções podem ir para o mesmo SolutionGroup:
+//
+//   SolutionWriter writer(STDOUT_FILENO);
+//   writer.begin();
+//   writer.write(instance, solution_a);
+//   writer.write(instance, solution_b);
+//   writer.finish();
+class SolutionWriter
+{
+public:
+    static const size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+    // Escreve num descritor já aberto (não é fechado no fim)
+    explicit SolutionWriter(int fd, size_t buffer_size = DEFAULT_BUFFER_SIZE);
+
+    // Cria/trunca o arquivo em path; failed() indica erro de abertura
+    explicit SolutionWriter(const string &path, size_t buffer_size = DEFAULT_BUFFER_SIZE);
+
+    // Fecha o documento se necessário e descarrega o buffer
+    ~SolutionWriter();
+
+    SolutionWriter(const SolutionWriter &) = delete;
+    SolutionWriter &operator=(const SolutionWriter &) = delete;
+
+    // Abre o arquivo e o SolutionGroup (com metadados e data atual)
+    void begin(const string &group_id = "GeneratedSolution");
+
+    // Acrescenta uma <Solution> para a instância; aulas não alocadas são omitidas
+    void write(const Instance &instance, const vector<Allocation> &allocations);
+    void write(const Instance &instance, const Solution &solution);
+
+    // Fecha o SolutionGroup e o arquivo e descarrega o buffer
+    void finish();
+
+    bool failed() const { return has_error; }
+
+private:
+    vector<char> buffer;
+    size_t used = 0;
+    int fd;
+    bool owns_fd = false;
+    bool has_error = false;
+    bool in_group = false; // begin() chamado e finish() ainda não
+
+    void flush();
+    void put(const char *data, size_t size);
+    void put(const char *text);
+    void put(const string &text) { put(text.data(), text.size()); }
+    void put_int(int value);
+    void put_escaped(const string &text); // valor de atributo/texto com &, <, > e " escapados
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef STOPCRITERIA
+#define STOPCRITERIA
+
+#include <chrono>
+#include <functional>
+
+using namespace std;
+
+// Critérios de parada comuns a todos os solvers: prazo em tempo de relógio e custo alvo.
+// Os solvers chamam start() ao começar, should_stop() a cada iteração e improved() a cada melhora.
+class StopCriteria
+{
+public:
+    double time_limit = -1;  // segundos desde start(); negativo = sem prazo
+    double target_cost = -1; // para quando o melhor custo for <= alvo; negativo = sem alvo
+
+    // Chamado a cada nova melhor solução com (segundos desde start(), custo)
+    function<void(double, double)> on_improvement;
+
+    StopCriteria() {}
+
+    StopCriteria(double time_limit, double target_cost = -1) : time_limit(time_limit), target_cost(target_cost) {}
+
+    void start()
+    {
+        start_time = chrono::steady_clock::now();
+        if (time_limit >= 0)
+        {
+            deadline = start_time + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(time_limit));
+        }
+    }
+
+    double elapsed() const
+    {
+        return chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+    }
+
+    bool expired() const
+    {
+        return time_limit >= 0 && chrono::steady_clock::now() >= deadline;
+    }
+
+    bool reached(double best_cost) const
+    {
+        return target_cost >= 0 && best_cost <= target_cost;
+    }
+
+    bool should_stop(double best_cost) const
+    {
+        return reached(best_cost) || expired();
+    }
+
+    void improved(double cost) const
+    {
+        if (on_improvement)
+            on_improvement(elapsed(), cost);
+    }
+
+private:
+    chrono::steady_clock::time_point start_time;
+    chrono::steady_clock::time_point deadline;
+};
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef TABUSEARCH
+#define TABUSEARCH
+
+#include "Instance.h"
+#include "Solution.h"
+#include "IncrementalEvaluator.h"
+#include "Greedy.h"
+#include "StopCriteria.h"
+#include "RngStream.h"
+
+#include <vector>
+
+using namespace std;
+
+// Busca tabu sobre aulas: a cada iteração avalia (por delta) a realocação de uma amostra de aulas
+// para qualquer horário aceito pelo evento e algumas trocas entre aulas da mesma turma, e aplica
+// o melhor movimento não tabu, mesmo que piore. Depois de tirar uma aula do evento e do horário t,
+// voltar o evento para t fica tabu por tenure iterações, salvo se o movimento gerar uma nova melhor
+// solução (aspiração).
+class TabuSearch
+{
+public:
+    int min_tenure = 10;        // tenure sorteada em [min_tenure, min_tenure + tenure_range)
+    int tenure_range = 10;
+    int relocate_samples = 40;  // aulas avaliadas para realocação por iteração
+    int swap_samples = 10;      // trocas avaliadas por iteração
+    int stagnation_limit = 2000; // iterações sem nova melhor antes de voltar para ela
+
+    // O Greedy da solução inicial usa rng.split(0) e o limite de reinícios max_restarts
+    explicit TabuSearch(RngStream rng = RngStream(), int max_restarts = Greedy::DEFAULT_MAX_RESTARTS)
+        : rng(rng), greedy(max_restarts, rng.split(0)) {}
+
+    // Recomeça os fluxos a partir da semente mestre, para repetir uma execução
+    void seed(uint64_t value);
+
+    // Para após max_iters iterações (negativo = sem limite) ou quando stop indicar prazo/alvo atingido
+    Solution solve(Instance &instance, int max_iters, StopCriteria stop = StopCriteria());
+
+private:
+    // Movimento candidato: from sai, to entra (uma aula na realocação, duas na troca)
+    class Candidate
+    {
+    public:
+        vector<Allocation> from;
+        vector<Allocation> to;
+        int delta;
+    };
+
+    RngStream rng;
+    Greedy greedy;
+
+    int num_times = 0;
+    vector<int> tabu_until; // event * num_times + time -> iteração até a qual o par é tabu
+
+    bool is_tabu(int event_id, int time_id, int iteration) const
+    {
+        return time_id != Allocation::UNALLOCATED && tabu_until[event_id * num_times + time_id] > iteration;
+    }
+
+    // Melhor realocação permitida de uma aula sorteada; devolve false se nenhuma for permitida
+    bool best_relocation(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator,
+                         const Allocation &lesson, int iteration, int current_cost, int best_cost, Candidate &candidate);
+
+    // Troca de horário entre duas aulas da mesma turma, avaliada aplicando e desfazendo
+    bool evaluate_swap(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator,
+                       const Allocation &a, const Allocation &b, int iteration, int current_cost, int best_cost, Candidate &candidate);
+
+    void apply(Solution &solution, IncrementalEvaluator &evaluator, const Candidate &candidate, int iteration);
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef THREADPOOL
+#define THREADPOOL
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+using namespace std;
+
+// Pool fixo de threads. A thread que chama parallel_for também trabalha (worker 0).
+// Os índices são divididos em faixas, uma por worker; quem esvazia a sua rouba metade
+// da faixa de outro (work stealing), o que equilibra tarefas de duração muito diferente.
+class ThreadPool
+{
+private:
+    // Faixa [begin, end) de um worker num único atômico: o dono tira da frente, ladrões do fim
+    class alignas(64) Range
+    {
+    public:
+        atomic<uint64_t> bounds{0};
+
+        static uint64_t pack(uint32_t begin, uint32_t end) { return (uint64_t)begin << 32 | end; }
+        static uint32_t begin_of(uint64_t bounds) { return bounds >> 32; }
+        static uint32_t end_of(uint64_t bounds) { return (uint32_t)bounds; }
+    };
+
+    vector<thread> workers;
+    unique_ptr<Range[]> ranges;
+    mutex mtx;
+    condition_variable start_cv;
+    condition_variable done_cv;
+
+    const function<void(int, int)> *job = nullptr;
+    int running = 0;          // workers ainda dentro do job atual
+    long long generation = 0; // incrementado a cada parallel_for
+    bool stopping = false;
+
+    void worker_loop(int worker_id);
+    void run_job(int worker_id);
+    bool pop(int worker_id, int &index);
+    bool steal(int worker_id);
+
+public:
+    explicit ThreadPool(int num_threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    int size() const;
+
+    // Executa body(index, worker_id) para index em [0, n) e espera todos terminarem.
+    // worker_id está em [0, size()) e identifica a thread (ex.: para RNG próprio).
+    void parallel_for(int n, const function<void(int, int)> &body);
+};
+
+#endif
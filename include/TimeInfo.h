@@ -9,9 +9,10 @@ class TimeInfo
 {
 public:
     string id;
-    string day;
+    int index;
+    int day;          // índice em Instance::days
     int slot;
     int max_duration; // 1 ou 2
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,40 @@
+#ifndef VISITEDSET
+#define VISITEDSET
+
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// Conjunto pequeno de soluções já vistas, pelo hash (Solution::hash), com mapeamento direto:
+// cada hash tem uma única posição e um hash novo sobrescreve o antigo, então um hash esquecido
+// pode voltar a ser visto. O hash 0 marca posição vazia. Leituras concorrentes são seguras se
+// ninguém gravar ao mesmo tempo.
+class VisitedSet
+{
+public:
+    static const int DEFAULT_BITS = 12; // 4096 entradas
+
+    explicit VisitedSet(int bits = DEFAULT_BITS) : entries(size_t(1) << bits, 0), mask((size_t(1) << bits) - 1) {}
+
+    bool contains(uint64_t hash) const
+    {
+        return hash != 0 && entries[hash & mask] == hash;
+    }
+
+    void insert(uint64_t hash)
+    {
+        entries[hash & mask] = hash;
+    }
+
+    void clear()
+    {
+        entries.assign(entries.size(), 0);
+    }
+
+private:
+    vector<uint64_t> entries;
+    size_t mask;
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef XMLREADER
+#define XMLREADER
+
+#include <istream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Leitor XML em fluxo (pull parser): lê a entrada em blocos e devolve um token por vez,
+// sem montar a árvore do documento. Suporta o subconjunto usado pelos arquivos XHSTT:
+// elementos, atributos, texto, entidades, comentários, CDATA e declarações (ignoradas).
+class XmlReader
+{
+public:
+    enum Token
+    {
+        START,       // <nome ...> ou <nome .../> (neste caso o END vem em seguida)
+        END,         // </nome>
+        TEXT,        // texto entre tags, com entidades decodificadas
+        END_OF_FILE,
+        ERROR
+    };
+
+    explicit XmlReader(istream &in);
+
+    // Avança para o próximo token
+    Token next();
+
+    // Nome do elemento do último START/END
+    const string &name() const { return current_name; }
+
+    // Texto do último TEXT
+    const string &text() const { return current_text; }
+
+    // Atributo do último START; nullptr se não existir
+    const char *attribute(const char *attr_name) const;
+
+    // Profundidade do elemento atual (1 = raiz)
+    int depth() const { return current_depth; }
+
+    // Erro de sintaxe, tag de fechamento trocada ou fim do arquivo com elementos abertos
+    bool failed() const { return has_error; }
+
+    // Navegação estruturada. Depois de um START, o chamador deve consumir o elemento
+    // até o END correspondente (com skip(), read_text() ou next_child() até false).
+
+    // Avança até o próximo filho direto do elemento atual; false ao chegar no fim dele
+    bool next_child();
+
+    // Ignora o restante do elemento atual (o último START)
+    void skip();
+
+    // Lê o texto do elemento atual até o seu END (filhos aninhados são ignorados)
+    string read_text();
+
+private:
+    istream &in;
+    string buffer;
+    size_t pos = 0;
+    bool eof = false;
+    bool has_error = false;
+
+    string current_name;
+    string current_text;
+    vector<pair<string, string>> attributes;
+    int current_depth = 0;
+    bool pending_end = false;      // <nome/>: o END é devolvido na próxima chamada
+    vector<string> open_elements;  // pilha dos elementos abertos, para conferir cada END
+
+    bool fill(size_t needed);
+    int peek(size_t offset = 0);
+    int get();
+    bool starts_with(const char *s);
+    bool skip_until(const char *terminator);
+    void skip_spaces();
+    string read_name();
+    bool read_attribute_value(string &value);
+    void decode_entity(string &out);
+    Token fail();
+};
+
+#endif
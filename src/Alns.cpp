@@ -0,0 +1,507 @@
+#include "../include/Alns.h"
+#include "../include/IteratedGreedy.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+
+namespace
+{
+    int random_int(RngStream &rng, int n)
+    {
+        return uniform_int_distribution<int>(0, n - 1)(rng);
+    }
+
+    // Junta os eventos de grupos sorteados (ex.: eventos de um professor) até chegar em count
+    vector<int> take_from_groups(const vector<vector<int>> &groups, int count, RngStream &rng)
+    {
+        vector<int> order(groups.size());
+        for (int g = 0; g < (int)order.size(); g++)
+        {
+            order[g] = g;
+        }
+        shuffle(order.begin(), order.end(), rng);
+
+        vector<int> selected;
+        for (int g : order)
+        {
+            vector<int> members = groups[g];
+            shuffle(members.begin(), members.end(), rng);
+            for (int e : members)
+            {
+                if ((int)selected.size() >= count)
+                    return selected;
+                selected.push_back(e);
+            }
+        }
+        return selected;
+    }
+
+    vector<int> destroy_random(const Instance &instance, const Solution &, const IncrementalEvaluator &, int count, RngStream &rng)
+    {
+        vector<int> events(instance.events.size());
+        for (int e = 0; e < (int)events.size(); e++)
+        {
+            events[e] = e;
+        }
+        shuffle(events.begin(), events.end(), rng);
+        events.resize(min(count, (int)events.size()));
+        return events;
+    }
+
+    // Eventos de maior custo, com sorteio enviesado para o topo da lista (y^3)
+    vector<int> destroy_worst(const Instance &instance, const Solution &solution, const IncrementalEvaluator &evaluator, int count, RngStream &rng)
+    {
+        vector<int> ranked = IteratedGreedy::select_events(solution, instance, evaluator, instance.events.size());
+
+        vector<int> selected;
+        while ((int)selected.size() < count && !ranked.empty())
+        {
+            double y = rng.uniform();
+            int k = (int)(y * y * y * ranked.size());
+            selected.push_back(ranked[k]);
+            ranked.erase(ranked.begin() + k);
+        }
+        return selected;
+    }
+
+    vector<int> destroy_teacher(const Instance &instance, const Solution &, const IncrementalEvaluator &, int count, RngStream &rng)
+    {
+        return take_from_groups(instance.teacher_events, count, rng);
+    }
+
+    vector<int> destroy_class(const Instance &instance, const Solution &, const IncrementalEvaluator &, int count, RngStream &rng)
+    {
+        return take_from_groups(instance.class_events, count, rng);
+    }
+
+    // Eventos com aula em dias sorteados
+    vector<int> destroy_day(const Instance &instance, const Solution &solution, const IncrementalEvaluator &, int count, RngStream &rng)
+    {
+        vector<vector<int>> day_events(instance.days.size());
+        for (const EventInfo &e : instance.events)
+        {
+            for (int day = 0; day < (int)instance.days.size(); day++)
+            {
+                if (solution.event_day_counts[e.index][day] > 0)
+                    day_events[day].push_back(e.index);
+            }
+        }
+
+        vector<int> selected = take_from_groups(day_events, instance.events.size(), rng);
+
+        // Um evento pode ter aula em vários dias: remove repetições mantendo a ordem
+        vector<bool> seen(instance.events.size(), false);
+        vector<int> unique_events;
+        for (int e : selected)
+        {
+            if (!seen[e] && (int)unique_events.size() < count)
+            {
+                seen[e] = true;
+                unique_events.push_back(e);
+            }
+        }
+        return unique_events;
+    }
+
+    // Eventos com aula numa janela de horários consecutivos de um dia, janela após janela
+    vector<int> destroy_time_window(const Instance &instance, const Solution &solution, const IncrementalEvaluator &, int count, RngStream &rng)
+    {
+        const int WINDOW = 3;
+
+        vector<vector<int>> time_events(instance.times.size());
+        for (const Allocation &alloc : solution.allocations)
+        {
+            if (alloc.time_id == Allocation::UNALLOCATED)
+                continue;
+            time_events[alloc.time_id].push_back(alloc.event_id);
+            int next_id = instance.next_time[alloc.time_id];
+            if (alloc.duration == 2 && next_id >= 0)
+                time_events[next_id].push_back(alloc.event_id);
+        }
+
+        // Cada janela começa num horário e segue next_time
+        vector<vector<int>> windows;
+        for (const TimeInfo &t : instance.times)
+        {
+            vector<int> window;
+            for (int time_id = t.index, k = 0; time_id >= 0 && k < WINDOW; time_id = instance.next_time[time_id], k++)
+            {
+                window.insert(window.end(), time_events[time_id].begin(), time_events[time_id].end());
+            }
+            windows.push_back(window);
+        }
+
+        vector<bool> seen(instance.events.size(), false);
+        vector<int> selected;
+        for (int e : take_from_groups(windows, instance.events.size() * WINDOW * 2, rng))
+        {
+            if ((int)selected.size() >= count)
+                break;
+            if (!seen[e])
+            {
+                seen[e] = true;
+                selected.push_back(e);
+            }
+        }
+        return selected;
+    }
+
+    void repair_greedy(const Instance &instance, Solution &solution, vector<int> &destroyed, RngStream &rng, int max_restarts)
+    {
+        Greedy greedy(max_restarts, rng);
+        greedy.generate_greedy(destroyed, solution, instance);
+        rng = greedy.rng;
+    }
+
+    // Melhor e segunda melhor aula possível para o evento (custo por unidade de duração)
+    class Insertion
+    {
+    public:
+        Allocation alloc;
+        double cost = 1e18;
+    };
+
+    void best_two(const Instance &instance, const Solution &solution, const IncrementalEvaluator &evaluator,
+                  int event_id, RngStream &rng, Insertion &best, Insertion &second)
+    {
+        const EventInfo &event = instance.events[event_id];
+        int remaining = event.total_duration - solution.allocated_duration[event_id];
+        best = Insertion();
+        second = Insertion();
+        int ties = 0;
+
+        for (int duration = min(remaining, 2); duration >= 1; duration--)
+        {
+            uint64_t candidates = Greedy::candidate_times(instance, solution, event, duration);
+            for (; candidates; candidates &= candidates - 1)
+            {
+                int time_id = __builtin_ctzll(candidates);
+                double cost = (double)evaluator.delta_insert(solution, event_id, time_id, duration) / duration;
+
+                // Empates sorteados uniformemente
+                bool replace = cost < best.cost;
+                if (cost == best.cost)
+                    replace = random_int(rng, ++ties + 1) == 0;
+                else if (replace)
+                    ties = 0;
+
+                if (replace)
+                {
+                    second = best;
+                    best.alloc = {event_id, time_id, duration};
+                    best.cost = cost;
+                }
+                else if (cost < second.cost)
+                {
+                    second.alloc = {event_id, time_id, duration};
+                    second.cost = cost;
+                }
+            }
+        }
+    }
+
+    void insert(Solution &solution, IncrementalEvaluator &evaluator, const Allocation &alloc)
+    {
+        IncrementalEvaluator::Move move;
+        move.kind = IncrementalEvaluator::Move::INSERT;
+        move.alloc = alloc;
+        evaluator.apply(solution, move);
+    }
+
+    // Sem horário livre: o que sobrou fica como aula não alocada
+    void insert_unassigned(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator, int event_id)
+    {
+        Allocation alloc;
+        alloc.event_id = event_id;
+        alloc.time_id = Allocation::UNALLOCATED;
+        alloc.duration = instance.events[event_id].total_duration - solution.allocated_duration[event_id];
+        insert(solution, evaluator, alloc);
+    }
+
+    // Eventos mais restritos primeiro; cada aula vai para o horário de menor delta
+    void repair_best(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator, vector<int> &destroyed, RngStream &rng)
+    {
+        vector<pair<int, int>> order;
+        for (int e : destroyed)
+        {
+            const EventInfo &event = instance.events[e];
+            order.push_back({__builtin_popcountll(Greedy::candidate_times(instance, solution, event, 1)), e});
+        }
+        shuffle(order.begin(), order.end(), rng);
+        stable_sort(order.begin(), order.end(), [](const pair<int, int> &a, const pair<int, int> &b)
+                    { return a.first < b.first; });
+
+        for (const auto &entry : order)
+        {
+            int e = entry.second;
+            while (solution.allocated_duration[e] < instance.events[e].total_duration)
+            {
+                Insertion best, second;
+                best_two(instance, solution, evaluator, e, rng, best, second);
+                if (best.cost >= 1e18)
+                {
+                    insert_unassigned(instance, solution, evaluator, e);
+                    break;
+                }
+                insert(solution, evaluator, best.alloc);
+            }
+        }
+    }
+
+    // Regret-2: insere primeiro a aula do evento que mais perde se a melhor opção sumir
+    void repair_regret(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator, vector<int> &destroyed, RngStream &rng)
+    {
+        vector<int> pending = destroyed;
+        while (!pending.empty())
+        {
+            int chosen = -1;
+            double chosen_regret = -1;
+            Insertion chosen_insertion;
+
+            for (int k = 0; k < (int)pending.size(); k++)
+            {
+                int e = pending[k];
+                if (solution.allocated_duration[e] >= instance.events[e].total_duration)
+                    continue;
+
+                Insertion best, second;
+                best_two(instance, solution, evaluator, e, rng, best, second);
+                if (best.cost >= 1e18)
+                {
+                    insert_unassigned(instance, solution, evaluator, e);
+                    continue;
+                }
+
+                double regret = second.cost >= 1e18 ? 1e17 : second.cost - best.cost;
+                if (regret > chosen_regret)
+                {
+                    chosen = k;
+                    chosen_regret = regret;
+                    chosen_insertion = best;
+                }
+            }
+
+            if (chosen >= 0)
+                insert(solution, evaluator, chosen_insertion.alloc);
+
+            // Tira da lista os eventos já completos (ou marcados como não alocados)
+            pending.erase(remove_if(pending.begin(), pending.end(), [&](int e)
+                                    { return solution.allocated_duration[e] >= instance.events[e].total_duration ||
+                                             (!solution.event_allocations[e].empty() &&
+                                              solution.event_allocations[e].back().time_id == Allocation::UNALLOCATED); }),
+                          pending.end());
+        }
+    }
+}
+
+Alns::Alns(RngStream rng, int max_restarts) : rng(rng), max_restarts(max_restarts)
+{
+    register_default_operators();
+}
+
+void Alns::register_default_operators()
+{
+    register_destroy("random", destroy_random);
+    register_destroy("worst_cost", destroy_worst);
+    register_destroy("teacher", destroy_teacher);
+    register_destroy("class", destroy_class);
+    register_destroy("day", destroy_day);
+    register_destroy("time_window", destroy_time_window);
+
+    int restarts = max_restarts;
+    register_repair("greedy", [restarts](const Instance &instance, Solution &solution, IncrementalEvaluator &,
+                                         vector<int> &destroyed, RngStream &rng)
+                    { repair_greedy(instance, solution, destroyed, rng, restarts); });
+    register_repair("best_insertion", repair_best);
+    register_repair("regret_2", repair_regret);
+}
+
+void Alns::register_destroy(const string &name, DestroyFunction destroy)
+{
+    destroys.push_back(destroy);
+    destroy_info.push_back(OperatorStats());
+    destroy_info.back().name = name;
+    destroy_scores.push_back(0);
+    destroy_segment_uses.push_back(0);
+}
+
+void Alns::register_repair(const string &name, RepairFunction repair)
+{
+    repairs.push_back(repair);
+    repair_info.push_back(OperatorStats());
+    repair_info.back().name = name;
+    repair_scores.push_back(0);
+    repair_segment_uses.push_back(0);
+}
+
+int Alns::select(const vector<OperatorStats> &operators)
+{
+    double total = 0;
+    for (const OperatorStats &op : operators)
+    {
+        total += op.weight;
+    }
+
+    double r = rng.uniform() * total;
+    for (int k = 0; k < (int)operators.size(); k++)
+    {
+        r -= operators[k].weight;
+        if (r < 0)
+            return k;
+    }
+    return operators.size() - 1;
+}
+
+void Alns::update_weights(vector<OperatorStats> &operators, vector<double> &scores, vector<int> &segment_uses)
+{
+    for (int k = 0; k < (int)operators.size(); k++)
+    {
+        if (segment_uses[k] > 0)
+        {
+            operators[k].weight = operators[k].weight * (1 - reaction) + reaction * scores[k] / segment_uses[k];
+        }
+        // Peso mínimo para que nenhum operador desapareça de vez
+        operators[k].weight = max(operators[k].weight, 0.05);
+        scores[k] = 0;
+        segment_uses[k] = 0;
+    }
+}
+
+Solution Alns::solve(Instance &instance, int max_iters, float destruction_percentage, StopCriteria stop)
+{
+    stop.start();
+
+    int total_events = instance.events.size();
+    int max_destroy = max(1, static_cast<int>(total_events * destruction_percentage));
+    int min_destroy = max(1, max_destroy / 2);
+
+    Greedy greedy(max_restarts, rng.split(0));
+    Solution current_solution = greedy.generate_greedy(instance);
+    IncrementalEvaluator evaluator(instance);
+    evaluator.reset(current_solution);
+
+    int current_cost = evaluator.objective();
+    Solution best_solution = current_solution;
+    int best_cost = current_cost;
+    stop.improved(best_cost);
+
+    // Temperatura inicial aceita 5% de piora com probabilidade 1/2; esfria até 0,2% dela
+    double initial_temp = max(1.0, 0.05 * current_cost / log(2.0));
+    double final_ratio = 0.002;
+    double temperature = initial_temp;
+
+    for (int i = 0; max_iters < 0 || i < max_iters; i++)
+    {
+        if (stop.should_stop(best_cost))
+            break;
+
+        int d = select(destroy_info);
+        int r = select(repair_info);
+        int count = min_destroy + random_int(rng, max_destroy - min_destroy + 1);
+
+        auto t0 = chrono::steady_clock::now();
+        current_solution.begin_transaction();
+        vector<int> destroyed = destroys[d](instance, current_solution, evaluator, count, rng);
+        for (int event_id : destroyed)
+        {
+            IteratedGreedy::remove_allocations(event_id, current_solution, instance);
+        }
+        evaluator.rescore(current_solution, destroyed);
+
+        auto t1 = chrono::steady_clock::now();
+        repairs[r](instance, current_solution, evaluator, destroyed, rng);
+        evaluator.rescore(current_solution, destroyed);
+        int new_cost = evaluator.objective();
+        auto t2 = chrono::steady_clock::now();
+
+        destroy_info[d].seconds += chrono::duration<double>(t1 - t0).count();
+        repair_info[r].seconds += chrono::duration<double>(t2 - t1).count();
+        destroy_info[d].uses++;
+        repair_info[r].uses++;
+        destroy_segment_uses[d]++;
+        repair_segment_uses[r]++;
+
+        double score = 0;
+        bool accept = new_cost < current_cost || rng.uniform() < exp(-(new_cost - current_cost) / temperature);
+        if (accept)
+        {
+            current_solution.commit();
+
+            destroy_info[d].accepted++;
+            repair_info[r].accepted++;
+
+            if (new_cost < best_cost)
+            {
+                best_solution = current_solution;
+                best_cost = new_cost;
+                stop.improved(best_cost);
+                destroy_info[d].new_best++;
+                repair_info[r].new_best++;
+                score = score_new_best;
+            }
+            else if (new_cost < current_cost)
+                score = score_improved;
+            else if (new_cost > current_cost)
+                score = score_accepted;
+
+            if (new_cost < current_cost)
+            {
+                destroy_info[d].improved++;
+                repair_info[r].improved++;
+            }
+            current_cost = new_cost;
+        }
+        else
+        {
+            current_solution.rollback(instance);
+            evaluator.rescore(current_solution, destroyed);
+        }
+
+        destroy_scores[d] += score;
+        repair_scores[r] += score;
+
+        if ((i + 1) % segment_length == 0)
+        {
+            update_weights(destroy_info, destroy_scores, destroy_segment_uses);
+            update_weights(repair_info, repair_scores, repair_segment_uses);
+        }
+
+        // Resfriamento pelo progresso: o maior entre iterações e tempo consumidos
+        double progress = -1;
+        if (max_iters > 0)
+            progress = (double)(i + 1) / max_iters;
+        if (stop.time_limit > 0)
+            progress = max(progress, stop.elapsed() / stop.time_limit);
+
+        if (progress >= 0)
+            temperature = initial_temp * pow(final_ratio, min(progress, 1.0));
+        else
+            temperature = max(temperature * 0.999, initial_temp * final_ratio);
+    }
+
+    return best_solution;
+}
+
+void Alns::print_statistics(ostream &out) const
+{
+    auto print = [&](const string &title, const vector<OperatorStats> &operators)
+    {
+        out << title << "\n";
+        out << "  " << left << setw(16) << "operador" << right << setw(8) << "peso" << setw(8) << "usos"
+            << setw(10) << "aceitos" << setw(10) << "melhoras" << setw(8) << "novas" << setw(10) << "sucesso"
+            << setw(10) << "tempo(s)" << "\n";
+        for (const OperatorStats &op : operators)
+        {
+            out << "  " << left << setw(16) << op.name << right << fixed << setprecision(2) << setw(8) << op.weight
+                << setw(8) << op.uses << setw(10) << op.accepted << setw(10) << op.improved << setw(8) << op.new_best
+                << setw(9) << setprecision(1) << 100 * op.success_rate() << "%" << setw(10) << setprecision(3)
+                << op.seconds << "\n";
+        }
+        out.unsetf(ios::fixed);
+    };
+
+    print("Operadores de destruição:", destroy_info);
+    print("Operadores de reparo:", repair_info);
+}
@@ -0,0 +1,362 @@
+#include "../include/Batch.h"
+#include "../include/IteratedGreedy.h"
+#include "../include/BeeColony.h"
+#include "../include/IslandModel.h"
+#include "../include/Alns.h"
+#include "../include/TabuSearch.h"
+#include "../include/SimulatedAnnealing.h"
+#include "../include/Evaluator.h"
+#include "../include/SolutionWriter.h"
+#include "../include/ThreadPool.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <cerrno>
+#include <cstring>
+
+#include <sys/stat.h>
+
+string BatchConfig::label() const
+{
+    return algorithm + "_s" + to_string(seed);
+}
+
+namespace
+{
+    // Conversões que exigem o valor inteiro válido (stoi e afins aceitam "12abc" e lançam exceções)
+    bool parse_int(const string &value, int &out, int min_value = INT_MIN)
+    {
+        try
+        {
+            size_t used;
+            out = stoi(value, &used);
+            return used == value.size() && out >= min_value;
+        }
+        catch (const exception &)
+        {
+            return false;
+        }
+    }
+
+    bool parse_double(const string &value, double &out)
+    {
+        try
+        {
+            size_t used;
+            out = stod(value, &used);
+            return used == value.size();
+        }
+        catch (const exception &)
+        {
+            return false;
+        }
+    }
+
+    bool parse_seed(const string &value, uint32_t &out)
+    {
+        if (value.empty() || value.find_first_not_of("0123456789") != string::npos)
+            return false;
+        try
+        {
+            unsigned long long seed = stoull(value);
+            if (seed > UINT32_MAX)
+                return false;
+            out = seed;
+            return true;
+        }
+        catch (const exception &)
+        {
+            return false;
+        }
+    }
+}
+
+vector<BatchConfig> BatchConfig::parse_file(const string &path)
+{
+    vector<BatchConfig> configs;
+
+    ifstream file(path);
+    if (!file)
+    {
+        cerr << "Erro ao abrir o arquivo de configurações: " << path << endl;
+        return configs;
+    }
+
+    string line;
+    int line_number = 0;
+    while (getline(file, line))
+    {
+        line_number++;
+        istringstream tokens(line);
+
+        BatchConfig config;
+        if (!(tokens >> config.algorithm) || config.algorithm[0] == '#')
+            continue;
+
+        if (config.algorithm != "ig" && config.algorithm != "ig_parallel" && config.algorithm != "abc" &&
+            config.algorithm != "alns" && config.algorithm != "tabu" && config.algorithm != "sa" &&
+            config.algorithm != "islands")
+        {
+            cerr << path << ":" << line_number << ": algoritmo desconhecido: " << config.algorithm << endl;
+            continue;
+        }
+
+        uint32_t first_seed = config.seed;
+        uint32_t last_seed = config.seed;
+
+        // Uma opção sem '=', uma chave desconhecida ou um valor inválido descarta a linha inteira, em vez de rodar com o valor padrão
+        bool valid = true;
+        string option;
+        while (valid && tokens >> option)
+        {
+            size_t eq = option.find('=');
+            if (eq == string::npos)
+            {
+                cerr << path << ":" << line_number << ": opção inválida: " << option << endl;
+                valid = false;
+                continue;
+            }
+            string key = option.substr(0, eq);
+            string value = option.substr(eq + 1);
+
+            if (key == "iterations")
+                valid = parse_int(value, config.iterations);
+            else if (key == "destruction")
+                valid = parse_double(value, config.destruction) && config.destruction > 0 && config.destruction <= 1;
+            else if (key == "pop")
+                valid = parse_int(value, config.pop_size, 1);
+            else if (key == "limit")
+                valid = parse_int(value, config.limit, 1);
+            else if (key == "threads")
+                valid = parse_int(value, config.threads, 1);
+            else if (key == "sync")
+                valid = parse_int(value, config.sync_interval, 1);
+            else if (key == "time")
+                valid = parse_double(value, config.time_limit);
+            else if (key == "target")
+                valid = parse_double(value, config.target_cost);
+            else if (key == "restarts")
+                valid = parse_int(value, config.restarts);
+            else if (key == "seed")
+            {
+                valid = parse_seed(value, first_seed);
+                last_seed = first_seed;
+            }
+            else if (key == "seeds")
+            {
+                size_t dash = value.find('-');
+                valid = parse_seed(value.substr(0, dash), first_seed);
+                last_seed = first_seed;
+                if (valid && dash != string::npos)
+                    valid = parse_seed(value.substr(dash + 1), last_seed) && first_seed <= last_seed;
+            }
+            else
+            {
+                cerr << path << ":" << line_number << ": opção desconhecida: " << key << endl;
+                valid = false;
+                continue;
+            }
+
+            if (!valid)
+                cerr << path << ":" << line_number << ": valor inválido: " << option << endl;
+        }
+        if (!valid)
+            continue;
+
+        // Contador de 64 bits: last_seed pode ser UINT32_MAX
+        for (uint64_t seed = first_seed; seed <= last_seed; seed++)
+        {
+            config.seed = seed;
+            configs.push_back(config);
+        }
+    }
+
+    return configs;
+}
+
+int Batch::job_threads(const BatchConfig &config, int num_threads)
+{
+    // As threads do ABC não mudam o resultado e podem ser limitadas; o número de ilhas e de cadeias
+    // faz parte da configuração
+    if (config.algorithm == "abc")
+        return max(1, min(config.threads, num_threads));
+    if (config.algorithm == "islands" || config.algorithm == "ig_parallel")
+        return max(1, config.threads);
+    return 1;
+}
+
+Solution Batch::solve(Instance &instance, const BatchConfig &config, int threads)
+{
+    StopCriteria stop(config.time_limit, config.target_cost);
+
+    if (config.algorithm == "abc")
+    {
+        BeeColony bee_colony(instance, threads, RngStream(config.seed), config.restarts);
+        bee_colony.verbose = false;
+        bee_colony.solve(config.pop_size, config.limit, config.iterations, config.destruction, stop);
+        return bee_colony.getBestSolution();
+    }
+
+    if (config.algorithm == "islands")
+    {
+        IslandModel islands(instance, threads, RngStream(config.seed), config.restarts);
+        islands.migration_interval = config.sync_interval;
+        islands.verbose = false;
+        return islands.solve(config.pop_size, config.limit, config.iterations, config.destruction, stop);
+    }
+
+    if (config.algorithm == "alns")
+    {
+        Alns alns(RngStream(config.seed), config.restarts);
+        return alns.solve(instance, config.iterations, config.destruction, stop);
+    }
+
+    if (config.algorithm == "tabu")
+    {
+        TabuSearch tabu_search(RngStream(config.seed), config.restarts);
+        return tabu_search.solve(instance, config.iterations, stop);
+    }
+
+    if (config.algorithm == "sa")
+    {
+        SimulatedAnnealing annealing(RngStream(config.seed), config.restarts);
+        return annealing.solve(instance, config.iterations, stop);
+    }
+
+    IteratedGreedy iterated_greedy(RngStream(config.seed), config.restarts);
+    if (config.algorithm == "ig_parallel")
+    {
+        return iterated_greedy.solve_parallel(instance, config.iterations, config.destruction,
+                                              threads, config.sync_interval, stop);
+    }
+    return iterated_greedy.solve(instance, config.iterations, config.destruction, stop);
+}
+
+vector<BatchResult> Batch::run(const vector<string> &instance_paths, const vector<BatchConfig> &configs,
+                               int num_threads, const string &output_dir)
+{
+    int num_jobs = instance_paths.size() * configs.size();
+    vector<BatchResult> results(num_jobs);
+
+    if (mkdir(output_dir.c_str(), 0755) != 0 && errno != EEXIST)
+    {
+        cerr << "Erro ao criar o diretório de saída " << output_dir << ": " << strerror(errno) << endl;
+        for (BatchResult &result : results)
+            result.failed = true;
+        return results;
+    }
+
+    // Cada instância é carregada uma vez e só lida pelos jobs
+    vector<Instance> instances(instance_paths.size());
+    vector<string> names(instance_paths.size());
+    vector<char> loaded(instance_paths.size());
+    unordered_map<string, size_t> first_with_name;
+    for (size_t i = 0; i < instance_paths.size(); i++)
+    {
+        string name = instance_paths[i].substr(instance_paths[i].find_last_of('/') + 1);
+        names[i] = name.substr(0, name.rfind(".xml"));
+
+        // O nome vai para os arquivos de saída e para o results.csv: dois caminhos com o mesmo nome
+        // gravariam os mesmos arquivos
+        auto first = first_with_name.emplace(names[i], i).first;
+        if (first->second != i)
+        {
+            cerr << instance_paths[i] << ": mesmo nome de " << instance_paths[first->second]
+                 << "; seus jobs serão ignorados" << endl;
+            loaded[i] = false;
+            continue;
+        }
+
+        loaded[i] = instances[i].load(instance_paths[i]);
+        if (!loaded[i])
+            cerr << instance_paths[i] << ": instância não carregada; seus jobs serão ignorados" << endl;
+    }
+
+    mutex log_mtx;
+
+    // Os solvers paralelos criam as próprias threads (as ilhas esperam umas pelas outras e não
+    // podem dividir workers; parallel_for não é reentrante), então o pool do lote encolhe para
+    // que jobs simultâneos x threads por job caibam em num_threads
+    num_threads = max(1, num_threads);
+    int widest_job = 1;
+    for (const BatchConfig &config : configs)
+        widest_job = max(widest_job, job_threads(config, num_threads));
+    if (widest_job > num_threads)
+        cerr << "Aviso: há configurações com " << widest_job << " ilhas/cadeias, mais que as "
+             << num_threads << " threads do lote; esses jobs passam do limite" << endl;
+
+    ThreadPool pool(max(1, num_threads / widest_job));
+    pool.parallel_for(num_jobs, [&](int job, int)
+                      {
+                          int i = job / configs.size();
+                          int c = job % configs.size();
+                          const BatchConfig &config = configs[c];
+
+                          BatchResult &result = results[job];
+                          result.instance = names[i];
+                          result.config = config.label();
+                          result.seed = config.seed;
+                          if (!loaded[i])
+                          {
+                              result.failed = true;
+                              return;
+                          }
+
+                          auto start = chrono::steady_clock::now();
+                          Solution solution = solve(instances[i], config, job_threads(config, num_threads));
+                          double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+                          Evaluator evaluator;
+                          evaluator.evaluate(instances[i], solution);
+
+                          result.hard_violations = evaluator.hard_violations;
+                          result.soft_violations = evaluator.soft_violations;
+                          result.total_cost = evaluator.total_cost;
+                          result.seconds = seconds;
+                          result.solution_path = output_dir + "/" + names[i] + "__c" + to_string(c) + "_" + config.label() + ".xml";
+
+                          SolutionWriter writer(result.solution_path);
+                          writer.begin(config.label());
+                          writer.write(instances[i], solution);
+                          writer.finish();
+
+                          lock_guard<mutex> lock(log_mtx);
+                          if (writer.failed())
+                          {
+                              cerr << result.solution_path << ": erro ao gravar a solução" << endl;
+                              result.failed = true;
+                              return;
+                          }
+                          cerr << result.instance << " " << result.config << ": hard=" << result.hard_violations
+                               << " soft=" << result.soft_violations << " custo=" << result.total_cost
+                               << " (" << seconds << " s)" << endl;
+                      });
+
+    ofstream csv(output_dir + "/results.csv");
+    csv << "instance,config,seed,hard_violations,soft_violations,total_cost,seconds,solution\n";
+    for (const BatchResult &result : results)
+    {
+        if (result.failed)
+            continue;
+        csv << result.instance << "," << result.config << "," << result.seed << ","
+            << result.hard_violations << "," << result.soft_violations << "," << result.total_cost << ","
+            << result.seconds << "," << result.solution_path << "\n";
+    }
+
+    // Sem o results.csv o lote não tem saída utilizável: todos os jobs contam como falha
+    csv.close();
+    if (!csv)
+    {
+        cerr << "Erro ao gravar " << output_dir << "/results.csv" << endl;
+        for (BatchResult &result : results)
+            result.failed = true;
+    }
+
+    return results;
+}
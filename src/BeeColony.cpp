@@ -1,86 +1,106 @@
 #include "../include/BeeColony.h"
 
 #include <iostream>
-#include <chrono>
 #include <random>
 #include <algorithm>
 
-double BeeColony::evaluate(Solution &sol)
+double BeeColony::evaluate(int i)
 {
-    Evaluator evaluator;
-    evaluator.evaluate(instance, sol);
+    evaluators[i].reset(population[i]);
 
-    return evaluator.hard_violations * 1000 + evaluator.total_cost;
+    return evaluators[i].objective();
 }
 
-pair<Solution, vector<string>> BeeColony::destroy_random(Solution solution, int num_events)
+pair<Solution, vector<int>> BeeColony::destroy_random(const Solution &solution, int num_events, RngStream &rng)
 {
-    vector<string> all_event_ids;
+    vector<int> all_event_ids;
     for (const auto &e : instance.events)
     {
-        all_event_ids.push_back(e.id);
+        all_event_ids.push_back(e.index);
     }
 
-    unsigned seed = chrono::system_clock::now().time_since_epoch().count();
-    shuffle(all_event_ids.begin(), all_event_ids.end(), mt19937(seed));
+    shuffle(all_event_ids.begin(), all_event_ids.end(), rng);
 
-    vector<string> selected;
+    vector<int> selected;
     int n = min(num_events, (int)all_event_ids.size());
     for (int i = 0; i < n; i++)
     {
         selected.push_back(all_event_ids[i]);
     }
 
-    IteratedGreedy iterated_greedy;
-
-    for (const auto &event_id : selected)
+    // Única cópia da solução; o par devolvido fica com ela
+    pair<Solution, vector<int>> result(solution, move(selected));
+    for (const auto &event_id : result.second)
     {
-        iterated_greedy.remove_allocations(event_id, solution, instance);
+        IteratedGreedy::remove_allocations(event_id, result.first, instance);
     }
 
-    return {solution, selected};
+    return result;
 }
 
-Solution BeeColony::perturb_solution(Solution sol)
+pair<Solution, vector<int>> BeeColony::perturb_solution(const Solution &sol, Greedy &greedy, IncrementalEvaluator &evaluator,
+                                                     uint64_t &rebuilt_hash, bool &revisited)
 {
     int destruction_rate = max(1, (int)(instance.events.size() * this->destruction_rate));
-    auto [new_sol, destroyed] = destroy_random(sol, destruction_rate);
-
-    Greedy greedy;
+    pair<Solution, vector<int>> result = destroy_random(sol, destruction_rate, greedy.rng);
+    Solution &new_sol = result.first;
+    vector<int> &destroyed = result.second;
 
     greedy.generate_greedy(destroyed, new_sol, instance);
 
-    // for (const string &event_id : destroyed)
-    // {
-    //     if (instance.event_index.find(event_id) == instance.event_index.end())
-    //         continue;
-
-    //     int attempts = 0;
-    //     int max_attempts = 5; // rever
-    //     int remaining = instance.events[instance.event_index.at(event_id)].total_duration;
-
-    //     while (remaining > 0 && attempts < max_attempts)
-    //     {
-    //         greedy.generate_greedy(destroyed, new_sol, instance, false);
-    //         int allocated_after = new_sol.allocated_duration[event_id];
-    //         remaining = instance.events[instance.event_index.at(event_id)].total_duration - allocated_after;
-
-    //         if (remaining > 0)
-    //         {
-    //             ig.remove_allocations(event_id, new_sol, instance);
-    //             remaining = instance.events[instance.event_index.at(event_id)].total_duration;
-    //         }
-    //         attempts++;
-    //     }
-    // }
-
-    return new_sol;
+    // Reconstrução já vista em algum ciclo: não vale a pena avaliar de novo
+    rebuilt_hash = new_sol.hash;
+    revisited = visited.contains(rebuilt_hash);
+    if (revisited)
+        return result;
+
+    evaluator.rescore(new_sol, destroyed);
+
+    if (use_local_search)
+        local_search.improve(instance, new_sol, evaluator, greedy.rng, &destroyed);
+
+    return result;
 }
 
-BeeColony::BeeColony(Instance &inst) : instance(inst) {}
+BeeColony::BeeColony(Instance &inst, int num_threads, RngStream rng, int max_restarts)
+    : instance(inst), num_threads(max(1, num_threads)), rng(rng), max_restarts(max_restarts) {}
+
+void BeeColony::seed(uint64_t value)
+{
+    rng = RngStream(value);
+}
+
+void BeeColony::merge_candidate(int i, Solution &candidate, IncrementalEvaluator &candidate_evaluator, double candidate_cost)
+{
+    if (candidate_cost < costs[i])
+    {
+        population[i] = move(candidate);
+        costs[i] = candidate_cost;
+        evaluators[i] = move(candidate_evaluator);
+        trial_counters[i] = 0;
+        update_best(i);
+    }
+    else
+    {
+        trial_counters[i]++;
+    }
+}
+
+void BeeColony::update_best(int i)
+{
+    if (costs[i] < best_cost)
+    {
+        best_cost = costs[i];
+        best_solution = population[i];
+        stop.improved(best_cost);
+    }
+}
 
-void BeeColony::solve(int pop_size, int limit, int max_cycles, double destruction_rate)
+void BeeColony::solve(int pop_size, int limit, int max_cycles, double destruction_rate, StopCriteria stop)
 {
+    this->stop = stop;
+    this->stop.start();
+
     this->pop_size = pop_size;
     this->limit = limit;
     this->max_cycles = max_cycles;
@@ -90,47 +110,80 @@ void BeeColony::solve(int pop_size, int limit, int max_cycles, double destructio
     trial_counters.assign(pop_size, 0);
     costs.resize(pop_size);
     fitness.resize(pop_size);
+    evaluators.assign(pop_size, IncrementalEvaluator(instance));
     best_cost = 1e9;
+    visited.clear();
 
-    Greedy greedy;
+    ThreadPool pool(num_threads);
 
+    // Fluxos derivados da semente da colônia: fonte i usa split(i), observadora k usa split(pop_size + k)
+    source_greedies.clear();
+    onlooker_greedies.clear();
     for (int i = 0; i < pop_size; i++)
     {
-        population[i] = greedy.generate_greedy(instance);
-        costs[i] = evaluate(population[i]);
+        source_greedies.emplace_back(max_restarts, rng.split(i));
+        onlooker_greedies.emplace_back(max_restarts, rng.split(pop_size + i));
+    }
 
-        if (costs[i] < best_cost)
-        {
-            best_cost = costs[i];
-            best_solution = population[i];
-        }
+    pool.parallel_for(pop_size, [&](int i, int)
+                      {
+                          population[i] = source_greedies[i].generate_greedy(instance);
+                          costs[i] = evaluate(i);
+                      });
+
+    for (int i = 0; i < pop_size; i++)
+    {
+        update_best(i);
     }
 
-    for (int cycle = 0; cycle < max_cycles; cycle++)
+    // Candidatos gerados em paralelo e incorporados em ordem de índice
+    vector<Solution> candidates(pop_size);
+    vector<IncrementalEvaluator> candidate_evaluators(pop_size, IncrementalEvaluator(instance));
+    vector<double> candidate_costs(pop_size);
+    vector<uint64_t> candidate_rebuilt_hashes(pop_size);
+    vector<char> candidate_revisited(pop_size);
+
+    auto make_candidate = [&](int k, int source, Greedy &greedy)
+    {
+        candidate_evaluators[k] = evaluators[source];
+        bool revisited;
+        Solution new_solution = perturb_solution(population[source], greedy, candidate_evaluators[k],
+                                                 candidate_rebuilt_hashes[k], revisited).first;
+        candidate_revisited[k] = revisited;
+        candidate_costs[k] = candidate_evaluators[k].objective();
+        candidates[k] = move(new_solution);
+    };
+
+    // Reconstruções repetidas e candidatos iguais a uma fonte da população contam como tentativa
+    // sem melhora; visited só é gravado aqui, na thread principal
+    auto merge = [&](int source, int k)
     {
+        if (!candidate_revisited[k])
+            visited.insert(candidate_rebuilt_hashes[k]);
+
+        if (candidate_revisited[k] || is_duplicate(candidates[k].hash))
+            trial_counters[source]++;
+        else
+            merge_candidate(source, candidates[k], candidate_evaluators[k], candidate_costs[k]);
+    };
+
+    for (int cycle = 0; max_cycles < 0 || cycle < max_cycles; cycle++)
+    {
+        if (this->stop.should_stop(best_cost))
+            break;
+
         // Fase das abelhas operárias
+        pool.parallel_for(pop_size, [&](int i, int)
+                          { make_candidate(i, i, source_greedies[i]); });
+
         for (int i = 0; i < pop_size; i++)
         {
-            Solution new_solution = perturb_solution(population[i]);
-            double new_cost = evaluate(new_solution);
-            if (new_cost < costs[i])
-            {
-                population[i] = new_solution;
-                costs[i] = new_cost;
-                trial_counters[i] = 0;
-
-                if (new_cost < best_cost)
-                {
-                    best_cost = new_cost;
-                    best_solution = new_solution;
-                }
-            }
-            else
-            {
-                trial_counters[i]++;
-            }
+            merge(i, i);
         }
 
+        if (this->stop.should_stop(best_cost))
+            break;
+
         double total_fitness = 0.0;
         for (int i = 0; i < pop_size; i++)
         {
@@ -144,10 +197,11 @@ void BeeColony::solve(int pop_size, int limit, int max_cycles, double destructio
             probabilities[i] = fitness[i] / total_fitness;
         }
 
-        // Fase das abelhas observadoras
+        // Fase das abelhas observadoras: sorteio sobre o retrato das probabilidades
+        vector<int> selected(pop_size);
         for (int i = 0; i < pop_size; i++)
         {
-            double r = (double)rand() / RAND_MAX;
+            double r = rng.uniform();
             double sum_prob = 0.0;
             int selected_idx = 0;
 
@@ -160,52 +214,93 @@ void BeeColony::solve(int pop_size, int limit, int max_cycles, double destructio
                     break;
                 }
             }
+            selected[i] = selected_idx;
+        }
 
-            Solution new_solution = perturb_solution(population[selected_idx]);
-            double new_cost = evaluate(new_solution);
-
-            if (new_cost < costs[selected_idx])
-            {
-                population[selected_idx] = new_solution;
-                costs[selected_idx] = new_cost;
-                trial_counters[selected_idx] = 0;
+        pool.parallel_for(pop_size, [&](int i, int)
+                          { make_candidate(i, selected[i], onlooker_greedies[i]); });
 
-                if (new_cost < best_cost)
-                {
-                    best_cost = new_cost;
-                    best_solution = new_solution;
-                }
-            }
-            else
-            {
-                trial_counters[selected_idx]++;
-            }
+        for (int i = 0; i < pop_size; i++)
+        {
+            merge(selected[i], i);
         }
 
-        Greedy greedy;
+        if (this->stop.should_stop(best_cost))
+            break;
 
         // Fase das abelhas exploradoras
+        pool.parallel_for(pop_size, [&](int i, int)
+                          {
+                              if (trial_counters[i] >= limit)
+                              {
+                                  population[i] = source_greedies[i].generate_greedy(instance);
+                                  costs[i] = evaluate(i);
+                                  trial_counters[i] = 0;
+                              }
+                          });
+
         for (int i = 0; i < pop_size; i++)
         {
-            if (trial_counters[i] >= limit)
-            {
-                population[i] = greedy.generate_greedy(instance);
-                costs[i] = evaluate(population[i]);
-                trial_counters[i] = 0;
-
-                if (costs[i] < best_cost)
-                {
-                    best_cost = costs[i];
-                    best_solution = population[i];
-                }
-            }
+            update_best(i);
         }
 
-        if (cycle % 10 == 0)
+        if (verbose && cycle % 10 == 0)
         {
             cout << "Ciclo " << cycle << ": Melhor custo = " << best_cost << endl;
         }
+
+        if (on_cycle && !on_cycle(cycle))
+            break;
+    }
+}
+
+vector<Solution> BeeColony::best_sources(int count) const
+{
+    vector<int> order(population.size());
+    for (int i = 0; i < (int)order.size(); i++)
+    {
+        order[i] = i;
+    }
+    stable_sort(order.begin(), order.end(), [&](int a, int b)
+                { return costs[a] < costs[b]; });
+
+    vector<Solution> sources;
+    for (int k = 0; k < min(count, (int)order.size()); k++)
+    {
+        sources.push_back(population[order[k]]);
     }
+    return sources;
+}
+
+bool BeeColony::is_duplicate(uint64_t hash) const
+{
+    for (const Solution &source : population)
+    {
+        if (source.hash == hash)
+            return true;
+    }
+    return false;
+}
+
+bool BeeColony::immigrate(const Solution &solution)
+{
+    if (population.empty() || is_duplicate(solution.hash))
+        return false;
+
+    int worst = max_element(costs.begin(), costs.end()) - costs.begin();
+
+    IncrementalEvaluator evaluator(instance);
+    evaluator.reset(solution);
+    double cost = evaluator.objective();
+    if (cost >= costs[worst])
+        return false;
+
+    population[worst] = solution;
+    evaluators[worst] = move(evaluator);
+    costs[worst] = cost;
+    trial_counters[worst] = 0;
+    update_best(worst);
+    return true;
 }
 
 Solution BeeColony::getBestSolution()
@@ -0,0 +1,72 @@
+#include "../include/CompactSolution.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+bool CompactSolution::fits(const Instance &instance)
+{
+    return instance.events.size() <= UINT16_MAX && instance.times.size() < UNALLOCATED &&
+           (int)instance.teachers.size() <= MAX_TEACHERS && (int)instance.classes.size() <= MAX_CLASSES;
+}
+
+bool CompactSolution::assign(const Instance &instance, const Solution &solution)
+{
+    if (!fits(instance) || (int)solution.allocations.size() > MAX_LESSONS)
+        return false;
+
+    num_lessons = solution.allocations.size();
+    num_teachers = instance.teachers.size();
+    num_classes = instance.classes.size();
+    hash = 0;
+
+    for (int i = 0; i < num_lessons; i++)
+    {
+        const Allocation &alloc = solution.allocations[i];
+        lessons[i].event_id = alloc.event_id;
+        lessons[i].time_id = alloc.time_id == Allocation::UNALLOCATED ? UNALLOCATED : alloc.time_id;
+        lessons[i].duration = alloc.duration;
+        hash += Solution::allocation_key(alloc);
+    }
+
+    // Forma canônica: a ordem de allocations depende do histórico de inserções e remoções
+    sort(lessons, lessons + num_lessons, [](const Lesson &a, const Lesson &b)
+         {
+             if (a.event_id != b.event_id)
+                 return a.event_id < b.event_id;
+             if (a.time_id != b.time_id)
+                 return a.time_id < b.time_id;
+             return a.duration < b.duration;
+         });
+
+    copy(solution.occupancy.teacher_busy.begin(), solution.occupancy.teacher_busy.end(), teacher_busy);
+    copy(solution.occupancy.class_busy.begin(), solution.occupancy.class_busy.end(), class_busy);
+    fill(teacher_busy + num_teachers, teacher_busy + MAX_TEACHERS, 0);
+    fill(class_busy + num_classes, class_busy + MAX_CLASSES, 0);
+    return true;
+}
+
+Solution CompactSolution::expand(const Instance &instance) const
+{
+    Solution solution(instance);
+    for (int i = 0; i < num_lessons; i++)
+    {
+        Allocation alloc;
+        alloc.event_id = lessons[i].event_id;
+        alloc.time_id = lessons[i].time_id == UNALLOCATED ? Allocation::UNALLOCATED : lessons[i].time_id;
+        alloc.duration = lessons[i].duration;
+        solution.add_allocation(instance, alloc);
+    }
+    return solution;
+}
+
+bool CompactSolution::operator==(const CompactSolution &other) const
+{
+    return hash == other.hash && num_lessons == other.num_lessons &&
+           memcmp(lessons, other.lessons, num_lessons * sizeof(Lesson)) == 0;
+}
+
+size_t CompactSolution::used_bytes() const
+{
+    return offsetof(CompactSolution, lessons) + num_lessons * sizeof(Lesson);
+}
@@ -3,86 +3,176 @@
 #include <iostream>
 #include <algorithm>
 
+bool Evaluator::is_hard(ConstraintInfo::Type type)
+{
+    return type == ConstraintInfo::ASSIGN_TIME || type == ConstraintInfo::AVOID_CLASHES ||
+           type == ConstraintInfo::AVOID_UNAVAILABLE_TIMES || type == ConstraintInfo::SPREAD_EVENTS;
+}
+
 void Evaluator::evaluate(const Instance &instance, const Solution &solution)
 {
     hard_violations = 0;
     soft_violations = 0;
     total_cost = 0;
+    fill(type_violations, type_violations + ConstraintInfo::UNKNOWN, 0);
+    fill(type_costs, type_costs + ConstraintInfo::UNKNOWN, 0);
+    violations.clear();
+    event_costs.assign(instance.events.size(), 0);
+    teacher_costs.assign(instance.teachers.size(), 0);
+    class_costs.assign(instance.classes.size(), 0);
+
     check_hard_constraints(instance, solution);
     check_soft_constraints(instance, solution);
 }
 
+void Evaluator::add(const Violation &violation)
+{
+    if (is_hard(violation.type))
+        hard_violations += violation.count;
+    else
+    {
+        soft_violations += violation.count;
+        total_cost += violation.cost;
+    }
+
+    type_violations[violation.type] += violation.count;
+    type_costs[violation.type] += violation.cost;
+    violations.push_back(violation);
+
+    if (violation.event_id >= 0)
+        event_costs[violation.event_id] += violation.cost;
+    if (violation.teacher_id >= 0)
+        teacher_costs[violation.teacher_id] += violation.cost;
+    if (violation.class_id >= 0)
+        class_costs[violation.class_id] += violation.cost;
+}
+
+vector<int> Evaluator::events_at(const Instance &instance, const Solution &solution, const vector<int> &events, int time_id)
+{
+    vector<int> found;
+    for (int event_id : events)
+    {
+        for (const Allocation &alloc : solution.event_allocations[event_id])
+        {
+            if (alloc.time_id == Allocation::UNALLOCATED)
+                continue;
+            if (alloc.time_id == time_id || (alloc.duration == 2 && instance.next_time[alloc.time_id] == time_id))
+            {
+                found.push_back(event_id);
+                break;
+            }
+        }
+    }
+    return found;
+}
+
 void Evaluator::check_hard_constraints(const Instance &instance, const Solution &solution)
 {
+    const int HARD_WEIGHT = ConstraintInfo::HARD_WEIGHT;
+
     // AssignTimeConstraint
     for (const auto &event : instance.events)
     {
-        int allocated = 0;
-        if (solution.allocated_duration.find(event.id) != solution.allocated_duration.end())
-        {
-            allocated = solution.allocated_duration.at(event.id);
-        }
+        int allocated = solution.allocated_duration[event.index];
 
         if (allocated != event.total_duration)
         {
-            hard_violations++;
+            Violation v;
+            v.type = ConstraintInfo::ASSIGN_TIME;
+            v.constraint_index = instance.type_source[v.type];
+            v.cost = HARD_WEIGHT;
+            v.event_id = event.index;
+            v.teacher_id = event.teacher_id;
+            v.class_id = event.class_id;
+            add(v);
         }
     }
 
-    // AvoidClashesConstraint
-    unordered_map<string, set<string>> teacher_allocations;
-    unordered_map<string, set<string>> class_allocations;
-
-    for (const Allocation &alloc : solution.allocations)
+    // AvoidClashesConstraint: cada aula excedente num (professor ou turma, horário)
+    int num_times = instance.times.size();
+    for (int teacher_id = 0; teacher_id < (int)instance.teachers.size(); teacher_id++)
     {
-        if (alloc.time_id == "UNALLOCATED")
-            continue;
+        for (int time_id = 0; time_id < num_times; time_id++)
+        {
+            int load = solution.occupancy.teacher_count(teacher_id, time_id);
+            if (load <= 1)
+                continue;
 
-        const EventInfo &event = instance.events.at(instance.event_index.at(alloc.event_id));
+            Violation v;
+            v.type = ConstraintInfo::AVOID_CLASHES;
+            v.constraint_index = instance.type_source[v.type];
+            v.count = load - 1;
+            v.cost = v.count * HARD_WEIGHT;
+            v.teacher_id = teacher_id;
+            v.time_id = time_id;
+            add(v);
 
-        if (teacher_allocations[alloc.time_id].count(event.teacher_id))
-        {
-            hard_violations++;
+            for (int event_id : events_at(instance, solution, instance.teacher_events[teacher_id], time_id))
+            {
+                event_costs[event_id] += v.cost;
+            }
         }
-        teacher_allocations[alloc.time_id].insert(event.teacher_id);
-
-        if (class_allocations[alloc.time_id].count(event.class_id))
+    }
+    for (int class_id = 0; class_id < (int)instance.classes.size(); class_id++)
+    {
+        for (int time_id = 0; time_id < num_times; time_id++)
         {
-            hard_violations++;
+            int load = solution.occupancy.class_count(class_id, time_id);
+            if (load <= 1)
+                continue;
+
+            Violation v;
+            v.type = ConstraintInfo::AVOID_CLASHES;
+            v.constraint_index = instance.type_source[v.type];
+            v.count = load - 1;
+            v.cost = v.count * HARD_WEIGHT;
+            v.class_id = class_id;
+            v.time_id = time_id;
+            add(v);
+
+            for (int event_id : events_at(instance, solution, instance.class_events[class_id], time_id))
+            {
+                event_costs[event_id] += v.cost;
+            }
         }
-        class_allocations[alloc.time_id].insert(event.class_id);
     }
 
     // AvoidUnavailableTimesConstraint
     for (const Allocation &alloc : solution.allocations)
     {
-        if (alloc.time_id == "UNALLOCATED")
+        if (alloc.time_id == Allocation::UNALLOCATED)
             continue;
 
-        const EventInfo &event = instance.events.at(instance.event_index.at(alloc.event_id));
+        const EventInfo &event = instance.events[alloc.event_id];
 
-        if (instance.teacher_unavailable_times.count(event.teacher_id))
+        if (instance.is_teacher_unavailable(event.teacher_id, alloc.time_id))
         {
-            const auto &unavailable_times = instance.teacher_unavailable_times.at(event.teacher_id);
-            if (unavailable_times.count(alloc.time_id))
-            {
-                hard_violations++;
-            }
+            Violation v;
+            v.type = ConstraintInfo::AVOID_UNAVAILABLE_TIMES;
+            v.constraint_index = instance.teacher_unavailable_source[event.teacher_id][alloc.time_id];
+            v.cost = HARD_WEIGHT;
+            v.event_id = event.index;
+            v.teacher_id = event.teacher_id;
+            v.time_id = alloc.time_id;
+            add(v);
         }
     }
 
     // SpreadEventsConstraint
     for (const auto &event : instance.events)
     {
-        auto day_counts_it = solution.event_day_counts.find(event.id);
-        if (day_counts_it != solution.event_day_counts.end())
+        for (int day = 0; day < (int)solution.event_day_counts[event.index].size(); day++)
         {
-            for (const auto &day_count : day_counts_it->second)
+            if (solution.event_day_counts[event.index][day] > 1)
             {
-                if (day_count.second > 1)
-                {
-                    hard_violations++;
-                }
+                Violation v;
+                v.type = ConstraintInfo::SPREAD_EVENTS;
+                v.constraint_index = instance.type_source[v.type];
+                v.cost = HARD_WEIGHT;
+                v.event_id = event.index;
+                v.class_id = event.class_id;
+                v.day = day;
+                add(v);
             }
         }
     }
@@ -93,116 +183,64 @@ void Evaluator::check_soft_constraints(const Instance &instance, const Solution
     // DistributeSplitEventsConstraint
     for (const auto &event : instance.events)
     {
-        if (instance.course_split_constraints.count(event.course_id))
+        if (event.course_id >= 0 && instance.course_split_constraints[event.course_id].first >= 0)
         {
-            auto constraint = instance.course_split_constraints.at(event.course_id);
+            auto constraint = instance.course_split_constraints[event.course_id];
             int min_double = constraint.first;
             int max_double = constraint.second;
 
-            int actual_double = 0;
-            if (solution.event_double_lessons.count(event.id))
-            {
-                actual_double = solution.event_double_lessons.at(event.id);
-            }
+            int actual_double = solution.event_double_lessons[event.index];
 
             if (actual_double < min_double || actual_double > max_double)
             {
-                soft_violations++;
-                int cost = 1;
-                for (const auto &c : instance.constraints)
-                {
-                    if (c.type == "DistributeSplitEventsConstraint" &&
-                        c.applies_to_events.count(event.course_id))
-                    {
-                        cost = c.weight;
-                        break;
-                    }
-                }
-                total_cost += cost;
+                Violation v;
+                v.type = ConstraintInfo::DISTRIBUTE_SPLIT_EVENTS;
+                v.constraint_index = instance.course_split_source[event.course_id];
+                v.cost = instance.course_split_weight[event.course_id];
+                v.event_id = event.index;
+                v.class_id = event.class_id;
+                add(v);
             }
         }
     }
 
     // ClusterBusyTimesConstraint
-    for (const auto &teacher_pair : instance.teacher_name)
+    for (int teacher_id = 0; teacher_id < (int)instance.teachers.size(); teacher_id++)
     {
-        const string &teacher_id = teacher_pair.first;
-
-        if (instance.teacher_max_days.count(teacher_id))
+        if (instance.teacher_max_days[teacher_id] >= 0)
         {
-            int max_days = instance.teacher_max_days.at(teacher_id);
-            int actual_days = 0;
-
-            if (solution.teacher_schedule.count(teacher_id))
-            {
-                actual_days = solution.teacher_schedule.at(teacher_id).size();
-            }
+            int max_days = instance.teacher_max_days[teacher_id];
+            int actual_days = solution.teacher_schedule[teacher_id].size();
 
             if (actual_days > max_days)
             {
-                soft_violations++;
-                int cost = 1;
-                for (const auto &c : instance.constraints)
-                {
-                    if (c.type == "ClusterBusyTimesConstraint" &&
-                        c.applies_to_teachers.count(teacher_id))
-                    {
-                        cost = c.weight;
-                        break;
-                    }
-                }
-                total_cost += cost;
+                Violation v;
+                v.type = ConstraintInfo::CLUSTER_BUSY_TIMES;
+                v.constraint_index = instance.teacher_max_days_source[teacher_id];
+                v.cost = instance.teacher_max_days_weight[teacher_id];
+                v.teacher_id = teacher_id;
+                add(v);
             }
         }
     }
 
     // LimitIdleTimesConstraint
-    for (const auto &teacher_sched : solution.teacher_schedule)
-    {
-        const string &teacher_id = teacher_sched.first;
-        const set<string> &days = teacher_sched.second;
+    if (!instance.has_idle_constraint)
+        return;
 
-        for (const string &day : days)
+    for (int teacher_id = 0; teacher_id < (int)solution.teacher_schedule.size(); teacher_id++)
+    {
+        for (int day : solution.teacher_schedule[teacher_id])
         {
-            vector<int> slots;
-            for (const Allocation &alloc : solution.allocations)
+            if (Solution::has_idle_gap(solution.teacher_day_slots[teacher_id][day]))
             {
-                // Skip unallocated entries
-                if (alloc.time_id == "UNALLOCATED")
-                    continue;
-
-                const EventInfo &event = instance.events.at(instance.event_index.at(alloc.event_id));
-                if (event.teacher_id == teacher_id)
-                {
-                    const auto it_time = instance.time_index.find(alloc.time_id);
-                    if (it_time == instance.time_index.end())
-                        continue;
-                    const TimeInfo &t = instance.times.at(it_time->second);
-                    if (t.day == day)
-                    {
-                        slots.push_back(t.slot);
-                    }
-                }
-            }
-
-            sort(slots.begin(), slots.end());
-            for (int i = 1; i < slots.size(); i++)
-            {
-                if (slots[i] - slots[i - 1] > 1)
-                {
-                    soft_violations++;
-                    int cost = 1;
-                    for (const auto &c : instance.constraints)
-                    {
-                        if (c.type == "LimitIdleTimesConstraint")
-                        {
-                            cost = c.weight;
-                            break;
-                        }
-                    }
-                    total_cost += cost;
-                    break;
-                }
+                Violation v;
+                v.type = ConstraintInfo::LIMIT_IDLE_TIMES;
+                v.constraint_index = instance.idle_source;
+                v.cost = instance.idle_weight;
+                v.teacher_id = teacher_id;
+                v.day = day;
+                add(v);
             }
         }
     }
@@ -214,5 +252,14 @@ void Evaluator::print_report() const
     cout << "Violações HARD: " << hard_violations << endl;
     cout << "Violações SOFT: " << soft_violations << endl;
     cout << "Custo total: " << total_cost << endl;
+    for (int type = 0; type < ConstraintInfo::UNKNOWN; type++)
+    {
+        if (type_violations[type] == 0)
+            continue;
+        cout << "  " << ConstraintInfo::type_name((ConstraintInfo::Type)type) << ": " << type_violations[type] << " violações";
+        if (!is_hard((ConstraintInfo::Type)type))
+            cout << ", custo " << type_costs[type];
+        cout << endl;
+    }
     cout << (hard_violations == 0 ? "SOLUÇÃO VÁLIDA" : "SOLUÇÃO INVÁLIDA") << endl;
 }
@@ -1,36 +1,72 @@
 #include "../include/Greedy.h"
 
 #include <iostream>
-#include <chrono>
 #include <random>
 #include <algorithm>
 
-Solution Greedy::generate_greedy(const Instance &instance)
+uint64_t Greedy::candidate_times(const Instance &instance, const Solution &solution, const EventInfo &event, int duration)
 {
-    Solution sol;
-    bool complete_solution = false;
+    uint64_t candidates;
+    if (duration == 2)
+    {
+        candidates = solution.occupancy.free_double_starts(event.teacher_id, event.class_id, instance.event_double_times[event.index]);
+    }
+    else
+    {
+        candidates = solution.occupancy.free_times(event.teacher_id, event.class_id) & instance.event_single_times[event.index];
+    }
 
-    unsigned seed = chrono::system_clock::now().time_since_epoch().count();
-    mt19937 rng(seed);
+    // Dias em que o evento já tem aula ficam de fora
+    for (int day = 0; day < (int)instance.days.size(); day++)
+    {
+        if (solution.event_day_counts[event.index][day] > 0)
+            candidates &= ~instance.day_times[day];
+    }
+    return candidates;
+}
+
+int Greedy::pick_time(const Instance &instance, const Solution &solution, const EventInfo &event, int duration, RngStream &rng)
+{
+    uint64_t candidates = candidate_times(instance, solution, event, duration);
+    if (candidates == 0)
+        return -1;
 
-    while (!complete_solution)
+    // Sorteia um dos horários candidatos
+    return rng.pick_bit(candidates);
+}
+
+void Greedy::mark_unassigned(const Instance &instance, Solution &solution, const vector<int> &remaining_duration)
+{
+    for (const EventInfo &e : instance.events)
     {
-        sol = Solution();
-        complete_solution = true;
+        if (remaining_duration[e.index] <= 0)
+            continue;
 
-        for (const auto &t : instance.times)
-        {
-            sol.teacher_occupation[t.id] = unordered_set<string>();
-            sol.class_occupation[t.id] = unordered_set<string>();
-        }
+        Allocation alloc;
+        alloc.event_id = e.index;
+        alloc.time_id = Allocation::UNALLOCATED;
+        alloc.duration = remaining_duration[e.index];
+
+        solution.add_allocation(instance, alloc);
+    }
+}
+
+Solution Greedy::generate_greedy(const Instance &instance)
+{
+    Solution sol;
+    Solution best_partial;
+    vector<int> best_remaining;
+    int best_unplaced = -1;
+
+    for (int attempt = 0;; attempt++)
+    {
+        sol = Solution(instance);
+        int unplaced = 0;
 
-        unordered_map<string, set<string>> teacher_used;
-        unordered_map<string, set<string>> class_used;
-        unordered_map<string, set<string>> event_used_days;
-        unordered_map<string, int> remaining_duration;
+        vector<int> remaining_duration(instance.events.size());
         for (const auto &e : instance.events)
         {
-            remaining_duration[e.id] = e.total_duration;
+            remaining_duration[e.index] = e.total_duration;
         }
 
         vector<EventInfo> evs = instance.events;
@@ -43,171 +79,89 @@ Solution Greedy::generate_greedy(const Instance &instance)
 
         for (const auto &e : evs)
         {
-            while (remaining_duration[e.id] >= 2)
+            while (remaining_duration[e.index] >= 2)
             {
-                bool allocated = false;
-                vector<TimeInfo> shuffled_times = instance.times;
-                shuffle(shuffled_times.begin(), shuffled_times.end(), rng);
-
-                for (const auto &t : shuffled_times)
-                {
-                    if (instance.next_time.find(t.id) == instance.next_time.end())
-                        continue;
-
-                    string next_id = instance.next_time.at(t.id);
-
-                    if (teacher_used[e.teacher_id].count(next_id) || class_used[e.class_id].count(next_id))
-                        continue;
-                    if (t.max_duration < 2)
-                        continue;
-                    if (teacher_used[e.teacher_id].count(t.id))
-                        continue;
-                    if (class_used[e.class_id].count(t.id))
-                        continue;
-                    if (event_used_days[e.id].count(t.day))
-                        continue;
-                    if (instance.teacher_unavailable_times.count(e.teacher_id) &&
-                        instance.teacher_unavailable_times.at(e.teacher_id).count(t.id))
-                        continue;
-
-                    Allocation alloc;
-                    alloc.event_id = e.id;
-                    alloc.time_id = t.id;
-                    alloc.duration = 2;
-
-                    sol.allocations.push_back(alloc);
-                    sol.event_allocations[e.id].push_back(alloc);
-                    sol.allocated_duration[e.id] += 2;
-                    sol.event_day_counts[e.id][t.day]++;
-                    sol.event_double_lessons[e.id]++;
-                    sol.teacher_schedule[e.teacher_id].insert(t.day);
-                    sol.class_schedule[e.class_id].insert(t.day);
-                    sol.teacher_occupation[t.id].insert(e.teacher_id);
-                    sol.teacher_occupation[next_id].insert(e.teacher_id);
-                    sol.class_occupation[t.id].insert(e.class_id);
-                    sol.class_occupation[next_id].insert(e.class_id);
-
-                    teacher_used[e.teacher_id].insert(t.id);
-                    teacher_used[e.teacher_id].insert(next_id);
-                    class_used[e.class_id].insert(t.id);
-                    class_used[e.class_id].insert(next_id);
-                    event_used_days[e.id].insert(t.day);
-                    remaining_duration[e.id] -= 2;
-                    allocated = true;
-                    break;
-                }
-                if (!allocated)
+                int time_id = pick_time(instance, sol, e, 2, rng);
+                if (time_id < 0)
                     break;
+
+                Allocation alloc;
+                alloc.event_id = e.index;
+                alloc.time_id = time_id;
+                alloc.duration = 2;
+
+                sol.add_allocation(instance, alloc);
+
+                remaining_duration[e.index] -= 2;
             }
 
-            while (remaining_duration[e.id] > 0)
+            while (remaining_duration[e.index] > 0)
             {
-                bool allocated = false;
-                vector<TimeInfo> shuffled_times = instance.times;
-                shuffle(shuffled_times.begin(), shuffled_times.end(), rng);
-
-                for (const auto &t : shuffled_times)
+                int time_id = pick_time(instance, sol, e, 1, rng);
+                if (time_id < 0)
                 {
-                    if (teacher_used[e.teacher_id].count(t.id))
-                        continue;
-                    if (class_used[e.class_id].count(t.id))
-                        continue;
-                    if (event_used_days[e.id].count(t.day))
-                        continue;
-                    if (instance.teacher_unavailable_times.count(e.teacher_id) &&
-                        instance.teacher_unavailable_times.at(e.teacher_id).count(t.id))
-                        continue;
-
-                    Allocation alloc;
-                    alloc.event_id = e.id;
-                    alloc.time_id = t.id;
-                    alloc.duration = 1;
-
-                    sol.allocations.push_back(alloc);
-                    sol.event_allocations[e.id].push_back(alloc);
-                    sol.allocated_duration[e.id] += 1;
-                    sol.event_day_counts[e.id][t.day]++;
-                    sol.teacher_schedule[e.teacher_id].insert(t.day);
-                    sol.class_schedule[e.class_id].insert(t.day);
-                    sol.teacher_occupation[t.id].insert(e.teacher_id);
-                    sol.class_occupation[t.id].insert(e.class_id);
-
-                    teacher_used[e.teacher_id].insert(t.id);
-                    class_used[e.class_id].insert(t.id);
-                    event_used_days[e.id].insert(t.day);
-                    remaining_duration[e.id] -= 1;
-                    allocated = true;
-                    break;
-                }
-                // if (!allocated)
-                // {
-                //     complete_solution = false;
-                //     Allocation alloc;
-                //     alloc.event_id = e.id;
-                //     alloc.time_id = "UNALLOCATED";
-                //     alloc.duration = remaining_duration[e.id];
-                //     sol.allocations.push_back(alloc);
-                //     sol.event_allocations[e.id].push_back(alloc);
-                //     sol.allocated_duration[e.id] += remaining_duration[e.id];
-                //     break;
-                // }
-                if (!allocated)
-                {
-                    complete_solution = false;
+                    unplaced += remaining_duration[e.index];
                     break;
                 }
+
+                Allocation alloc;
+                alloc.event_id = e.index;
+                alloc.time_id = time_id;
+                alloc.duration = 1;
+
+                sol.add_allocation(instance, alloc);
+
+                remaining_duration[e.index] -= 1;
             }
         }
-        if (complete_solution)
-            break;
+
+        if (unplaced == 0)
+            return sol;
+
+        if (best_unplaced < 0 || unplaced < best_unplaced)
+        {
+            best_unplaced = unplaced;
+            best_partial = sol;
+            best_remaining = remaining_duration;
+        }
+
+        // Orçamento esgotado: devolve a melhor tentativa com as sobras marcadas
+        if (max_restarts >= 0 && attempt >= max_restarts)
+        {
+            mark_unassigned(instance, best_partial, best_remaining);
+            return best_partial;
+        }
     }
-    return sol;
 }
 
-void Greedy::generate_greedy(vector<string> destroyed_events, Solution &solution, Instance &instance)
+void Greedy::generate_greedy(vector<int> destroyed_events, Solution &solution, const Instance &instance)
 {
-    Solution base_solution = solution;
+    // As tentativas são desfeitas pelo diário da solução em vez de copiá-la
+    bool own_transaction = !solution.journaling;
+    if (own_transaction)
+    {
+        solution.begin_transaction();
+    }
+    size_t mark = solution.journal.size();
 
-    bool complete_solution = false;
+    vector<Solution::Change> best_changes;
+    vector<int> best_remaining;
+    int best_unplaced = -1;
 
     vector<EventInfo> to_realocate;
-    unordered_map<string, int> base_remaining_duration;
-
-    unsigned seed = chrono::system_clock::now().time_since_epoch().count();
-    mt19937 rng(seed);
+    vector<int> base_remaining_duration(instance.events.size(), 0);
 
     for (auto id : destroyed_events)
     {
-        const EventInfo event = instance.events[instance.event_index.at(id)];
+        const EventInfo event = instance.events[id];
         to_realocate.push_back(event);
         base_remaining_duration[id] = event.total_duration - solution.allocated_duration[id];
     }
 
-    auto is_teacher_free = [&](const string &time_id, const EventInfo &event)
+    for (int attempt = 0;; attempt++)
     {
-        return solution.teacher_occupation[time_id].find(event.teacher_id) == solution.teacher_occupation[time_id].end();
-    };
-
-    auto is_class_free = [&](const string &time_id, const EventInfo &event)
-    {
-        return solution.class_occupation[time_id].find(event.class_id) == solution.class_occupation[time_id].end();
-    };
-
-    auto is_day_available = [&](const string &day, const string &event_id)
-    {
-        if (solution.event_day_counts.find(event_id) == solution.event_day_counts.end())
-            return true;
-
-        if (solution.event_day_counts[event_id].find(day) == solution.event_day_counts[event_id].end())
-            return true;
-
-        return solution.event_day_counts[event_id][day] == 0;
-    };
-
-    while (!complete_solution)
-    {
-        solution = base_solution;
-        complete_solution = true;
+        solution.rollback_to(instance, mark);
+        int unplaced = 0;
 
         auto remaining_duration = base_remaining_duration;
 
@@ -220,102 +174,67 @@ void Greedy::generate_greedy(vector<string> destroyed_events, Solution &solution
 
         for (const auto &e : to_realocate)
         {
-            while (remaining_duration[e.id] >= 2)
+            while (remaining_duration[e.index] >= 2)
             {
-                bool allocated = false;
-                vector<TimeInfo> shuffled_times = instance.times;
-                shuffle(shuffled_times.begin(), shuffled_times.end(), rng);
-
-                for (const auto &t : shuffled_times)
-                {
-                    if (instance.next_time.find(t.id) == instance.next_time.end())
-                        continue;
-
-                    string next_id = instance.next_time.at(t.id);
-
-                    if (!is_teacher_free(next_id, e) || !is_class_free(next_id, e))
-                        continue;
-                    if (t.max_duration < 2)
-                        continue;
-                    if (!is_teacher_free(t.id, e))
-                        continue;
-                    if (!is_class_free(t.id, e))
-                        continue;
-                    if (!is_day_available(t.day, e.id))
-                        continue;
-                    if (instance.teacher_unavailable_times.count(e.teacher_id) && instance.teacher_unavailable_times.at(e.teacher_id).count(t.id))
-                        continue;
-
-                    Allocation alloc;
-                    alloc.event_id = e.id;
-                    alloc.time_id = t.id;
-                    alloc.duration = 2;
-
-                    solution.allocations.push_back(alloc);
-                    solution.event_allocations[e.id].push_back(alloc);
-                    solution.allocated_duration[e.id] += 2;
-                    solution.event_day_counts[e.id][t.day]++;
-                    solution.event_double_lessons[e.id]++;
-                    solution.teacher_schedule[e.teacher_id].insert(t.day);
-                    solution.class_schedule[e.class_id].insert(t.day);
-
-                    solution.teacher_occupation[t.id].insert(e.teacher_id);
-                    solution.teacher_occupation[next_id].insert(e.teacher_id);
-                    solution.class_occupation[t.id].insert(e.class_id);
-                    solution.class_occupation[next_id].insert(e.class_id);
-
-                    remaining_duration[e.id] -= 2;
-                    allocated = true;
-                    break;
-                }
-                if (!allocated)
+                int time_id = pick_time(instance, solution, e, 2, rng);
+                if (time_id < 0)
                     break;
+
+                Allocation alloc;
+                alloc.event_id = e.index;
+                alloc.time_id = time_id;
+                alloc.duration = 2;
+
+                solution.add_allocation(instance, alloc);
+
+                remaining_duration[e.index] -= 2;
             }
 
-            while (remaining_duration[e.id] > 0)
+            while (remaining_duration[e.index] > 0)
             {
-                bool allocated = false;
-                vector<TimeInfo> shuffled_times = instance.times;
-                shuffle(shuffled_times.begin(), shuffled_times.end(), rng);
-
-                for (const auto &t : shuffled_times)
+                int time_id = pick_time(instance, solution, e, 1, rng);
+                if (time_id < 0)
                 {
-                    if (!is_teacher_free(t.id, e))
-                        continue;
-                    if (!is_class_free(t.id, e))
-                        continue;
-                    if (!is_day_available(t.day, e.id))
-                        continue;
-                    if (instance.teacher_unavailable_times.count(e.teacher_id) && instance.teacher_unavailable_times[e.teacher_id].count(t.id))
-                        continue;
-
-                    Allocation alloc;
-                    alloc.event_id = e.id;
-                    alloc.time_id = t.id;
-                    alloc.duration = 1;
-
-                    solution.allocations.push_back(alloc);
-                    solution.event_allocations[e.id].push_back(alloc);
-                    solution.allocated_duration[e.id] += 1;
-                    solution.event_day_counts[e.id][t.day]++;
-                    solution.teacher_schedule[e.teacher_id].insert(t.day);
-                    solution.class_schedule[e.class_id].insert(t.day);
-                    solution.teacher_occupation[t.id].insert(e.teacher_id);
-                    solution.class_occupation[t.id].insert(e.class_id);
-
-                    remaining_duration[e.id] -= 1;
-                    allocated = true;
+                    unplaced += remaining_duration[e.index];
                     break;
                 }
 
-                if (!allocated)
-                {
-                    complete_solution = false;
-                    break;
-                }
+                Allocation alloc;
+                alloc.event_id = e.index;
+                alloc.time_id = time_id;
+                alloc.duration = 1;
+
+                solution.add_allocation(instance, alloc);
+
+                remaining_duration[e.index] -= 1;
             }
         }
-        if (complete_solution)
+
+        if (unplaced == 0)
             break;
+
+        if (best_unplaced < 0 || unplaced < best_unplaced)
+        {
+            best_unplaced = unplaced;
+            best_changes.assign(solution.journal.begin() + mark, solution.journal.end());
+            best_remaining = remaining_duration;
+        }
+
+        // Orçamento esgotado: refaz a melhor tentativa a partir do diário
+        if (max_restarts >= 0 && attempt >= max_restarts)
+        {
+            solution.rollback_to(instance, mark);
+            for (const Solution::Change &change : best_changes)
+            {
+                solution.add_allocation(instance, change.alloc);
+            }
+            mark_unassigned(instance, solution, best_remaining);
+            break;
+        }
+    }
+
+    if (own_transaction)
+    {
+        solution.commit();
     }
 }
@@ -0,0 +1,292 @@
+#include "../include/IncrementalEvaluator.h"
+
+#include <algorithm>
+
+IncrementalEvaluator::IncrementalEvaluator(const Instance &instance) : instance(&instance) {}
+
+void IncrementalEvaluator::reset(const Solution &solution)
+{
+    fill(violations, violations + ConstraintInfo::UNKNOWN, 0);
+    fill(costs, costs + ConstraintInfo::UNKNOWN, 0);
+
+    event_assign.assign(instance->events.size(), 0);
+    event_unavailable.assign(instance->events.size(), 0);
+    event_spread.assign(instance->events.size(), 0);
+    event_split.assign(instance->events.size(), 0);
+    teacher_cluster.assign(instance->teachers.size(), 0);
+    teacher_idle.assign(instance->teachers.size(), vector<int>(instance->days.size(), 0));
+
+    vector<int> events(instance->events.size());
+    for (int e = 0; e < (int)events.size(); e++)
+    {
+        events[e] = e;
+    }
+    rescore(solution, events);
+}
+
+void IncrementalEvaluator::rescore(const Solution &solution, const vector<int> &events)
+{
+    vector<int> teachers;
+    for (int event_id : events)
+    {
+        rescore_event(solution, event_id);
+
+        int teacher_id = instance->events[event_id].teacher_id;
+        if (find(teachers.begin(), teachers.end(), teacher_id) == teachers.end())
+        {
+            teachers.push_back(teacher_id);
+        }
+    }
+
+    for (int teacher_id : teachers)
+    {
+        rescore_teacher(solution, teacher_id);
+    }
+
+    add(ConstraintInfo::AVOID_CLASHES, solution.occupancy.clashes - violations[ConstraintInfo::AVOID_CLASHES], 1);
+}
+
+int IncrementalEvaluator::hard_violations() const
+{
+    return violations[ConstraintInfo::ASSIGN_TIME] + violations[ConstraintInfo::AVOID_CLASHES] +
+           violations[ConstraintInfo::AVOID_UNAVAILABLE_TIMES] + violations[ConstraintInfo::SPREAD_EVENTS];
+}
+
+int IncrementalEvaluator::soft_violations() const
+{
+    return violations[ConstraintInfo::DISTRIBUTE_SPLIT_EVENTS] + violations[ConstraintInfo::CLUSTER_BUSY_TIMES] +
+           violations[ConstraintInfo::LIMIT_IDLE_TIMES];
+}
+
+int IncrementalEvaluator::total_cost() const
+{
+    return costs[ConstraintInfo::DISTRIBUTE_SPLIT_EVENTS] + costs[ConstraintInfo::CLUSTER_BUSY_TIMES] +
+           costs[ConstraintInfo::LIMIT_IDLE_TIMES];
+}
+
+int IncrementalEvaluator::objective() const
+{
+    return hard_violations() * HARD_WEIGHT + total_cost();
+}
+
+int IncrementalEvaluator::event_cost(const Solution &solution, int event_id) const
+{
+    const EventInfo &event = instance->events[event_id];
+
+    int hard = event_assign[event_id] + event_unavailable[event_id] + event_spread[event_id];
+    for (const Allocation &alloc : solution.event_allocations[event_id])
+    {
+        if (alloc.time_id == Allocation::UNALLOCATED)
+            continue;
+
+        int next_id = instance->next_time[alloc.time_id];
+        for (int slot : {alloc.time_id, alloc.duration == 2 ? next_id : -1})
+        {
+            if (slot >= 0 && (solution.occupancy.teacher_count(event.teacher_id, slot) > 1 ||
+                              solution.occupancy.class_count(event.class_id, slot) > 1))
+                hard++;
+        }
+    }
+
+    int soft = event_split[event_id] * (event.course_id >= 0 ? instance->course_split_weight[event.course_id] : 1);
+    return hard * HARD_WEIGHT + soft;
+}
+
+int IncrementalEvaluator::teacher_days_cost(int teacher_id) const
+{
+    return teacher_cluster[teacher_id] * instance->teacher_max_days_weight[teacher_id];
+}
+
+int IncrementalEvaluator::teacher_idle_cost(int teacher_id, int day) const
+{
+    return teacher_idle[teacher_id][day] * instance->idle_weight;
+}
+
+int IncrementalEvaluator::delta_insert(const Solution &solution, int event_id, int time_id, int duration) const
+{
+    return delta(solution, event_id, time_id, duration, 1);
+}
+
+int IncrementalEvaluator::delta_remove(const Solution &solution, int event_id, int time_id, int duration) const
+{
+    return delta(solution, event_id, time_id, duration, -1);
+}
+
+void IncrementalEvaluator::apply(Solution &solution, const Move &move)
+{
+    if (move.kind == Move::INSERT)
+    {
+        solution.add_allocation(*instance, move.alloc);
+    }
+    else
+    {
+        solution.remove_allocation(*instance, move.alloc);
+    }
+    rescore(solution, {move.alloc.event_id});
+}
+
+void IncrementalEvaluator::undo(Solution &solution, const Move &move)
+{
+    Move inverse = move;
+    inverse.kind = (move.kind == Move::INSERT) ? Move::REMOVE : Move::INSERT;
+    apply(solution, inverse);
+}
+
+int IncrementalEvaluator::delta(const Solution &solution, int event_id, int time_id, int duration, int sign) const
+{
+    // Marcadores de aula não alocada não mudam o custo
+    if (time_id == Allocation::UNALLOCATED)
+        return 0;
+
+    const EventInfo &event = instance->events[event_id];
+    const TimeInfo &t = instance->times[time_id];
+    int hard = 0;
+    int soft = 0;
+
+    // AssignTimeConstraint
+    int allocated = solution.allocated_duration[event_id];
+    hard += (allocated + sign * duration != event.total_duration) - (allocated != event.total_duration);
+
+    // AvoidUnavailableTimesConstraint
+    if (instance->is_teacher_unavailable(event.teacher_id, time_id))
+    {
+        hard += sign;
+    }
+
+    // SpreadEventsConstraint
+    int day_count = solution.event_day_counts[event_id][t.day];
+    hard += (day_count + sign > 1) - (day_count > 1);
+
+    // AvoidClashesConstraint
+    int next_id = instance->next_time[time_id];
+    for (int slot : {time_id, duration == 2 ? next_id : -1})
+    {
+        if (slot < 0)
+            continue;
+
+        int teacher_load = solution.occupancy.teacher_count(event.teacher_id, slot);
+        int class_load = solution.occupancy.class_count(event.class_id, slot);
+        if (sign > 0)
+            hard += (teacher_load > 0) + (class_load > 0);
+        else
+            hard -= (teacher_load > 1) + (class_load > 1);
+    }
+
+    // DistributeSplitEventsConstraint (só eventos com curso têm a restrição)
+    if (duration == 2 && event.course_id >= 0)
+    {
+        int doubles = solution.event_double_lessons[event_id];
+        soft += (split_violation(event_id, doubles + sign) - split_violation(event_id, doubles)) *
+                instance->course_split_weight[event.course_id];
+    }
+
+    // ClusterBusyTimesConstraint
+    int days = solution.teacher_schedule[event.teacher_id].size();
+    int lessons_on_day = solution.teacher_day_lessons[event.teacher_id][t.day];
+    int new_days = days;
+    if (sign > 0 && lessons_on_day == 0)
+        new_days++;
+    else if (sign < 0 && lessons_on_day == 1)
+        new_days--;
+    soft += (cluster_violation(event.teacher_id, new_days) - teacher_cluster[event.teacher_id]) *
+            instance->teacher_max_days_weight[event.teacher_id];
+
+    // LimitIdleTimesConstraint
+    int idle = sign > 0 ? idle_violation(solution, event.teacher_id, t.day, time_id, -1)
+                        : idle_violation(solution, event.teacher_id, t.day, -1, time_id);
+    soft += (idle - teacher_idle[event.teacher_id][t.day]) * instance->idle_weight;
+
+    return hard * HARD_WEIGHT + soft;
+}
+
+int IncrementalEvaluator::split_violation(int event_id, int doubles) const
+{
+    const EventInfo &event = instance->events[event_id];
+    if (event.course_id < 0)
+        return 0;
+
+    const auto &limits = instance->course_split_constraints[event.course_id];
+    if (limits.first < 0)
+        return 0;
+
+    return (doubles < limits.first || doubles > limits.second) ? 1 : 0;
+}
+
+int IncrementalEvaluator::cluster_violation(int teacher_id, int days) const
+{
+    int max_days = instance->teacher_max_days[teacher_id];
+    return (max_days >= 0 && days > max_days) ? 1 : 0;
+}
+
+int IncrementalEvaluator::idle_violation(const Solution &solution, int teacher_id, int day, int added_time, int removed_time) const
+{
+    uint64_t slots = solution.teacher_day_slots[teacher_id][day];
+
+    if (added_time >= 0)
+    {
+        slots |= 1ULL << instance->times[added_time].slot;
+    }
+    if (removed_time >= 0 && solution.teacher_time_starts[teacher_id][removed_time] == 1)
+    {
+        slots &= ~(1ULL << instance->times[removed_time].slot);
+    }
+
+    return (instance->has_idle_constraint && Solution::has_idle_gap(slots)) ? 1 : 0;
+}
+
+void IncrementalEvaluator::rescore_event(const Solution &solution, int event_id)
+{
+    const EventInfo &event = instance->events[event_id];
+
+    int assign = solution.allocated_duration[event_id] != event.total_duration ? 1 : 0;
+
+    int unavailable = 0;
+    for (const Allocation &alloc : solution.event_allocations[event_id])
+    {
+        if (alloc.time_id != Allocation::UNALLOCATED &&
+            instance->is_teacher_unavailable(event.teacher_id, alloc.time_id))
+        {
+            unavailable++;
+        }
+    }
+
+    int spread = 0;
+    for (int day_count : solution.event_day_counts[event_id])
+    {
+        if (day_count > 1)
+            spread++;
+    }
+
+    int split = split_violation(event_id, solution.event_double_lessons[event_id]);
+    int weight = event.course_id >= 0 ? instance->course_split_weight[event.course_id] : 1;
+
+    add(ConstraintInfo::ASSIGN_TIME, assign - event_assign[event_id], 1);
+    add(ConstraintInfo::AVOID_UNAVAILABLE_TIMES, unavailable - event_unavailable[event_id], 1);
+    add(ConstraintInfo::SPREAD_EVENTS, spread - event_spread[event_id], 1);
+    add(ConstraintInfo::DISTRIBUTE_SPLIT_EVENTS, split - event_split[event_id], weight);
+
+    event_assign[event_id] = assign;
+    event_unavailable[event_id] = unavailable;
+    event_spread[event_id] = spread;
+    event_split[event_id] = split;
+}
+
+void IncrementalEvaluator::rescore_teacher(const Solution &solution, int teacher_id)
+{
+    int cluster = cluster_violation(teacher_id, solution.teacher_schedule[teacher_id].size());
+    add(ConstraintInfo::CLUSTER_BUSY_TIMES, cluster - teacher_cluster[teacher_id], instance->teacher_max_days_weight[teacher_id]);
+    teacher_cluster[teacher_id] = cluster;
+
+    for (int day = 0; day < (int)instance->days.size(); day++)
+    {
+        int idle = idle_violation(solution, teacher_id, day, -1, -1);
+        add(ConstraintInfo::LIMIT_IDLE_TIMES, idle - teacher_idle[teacher_id][day], instance->idle_weight);
+        teacher_idle[teacher_id][day] = idle;
+    }
+}
+
+void IncrementalEvaluator::add(ConstraintInfo::Type type, int diff, int weight)
+{
+    violations[type] += diff;
+    costs[type] += diff * weight;
+}
@@ -1,309 +1,601 @@
 #include "../include/Instance.h"
+#include "../include/InstanceCache.h"
+#include "../include/XmlReader.h"
 
 #include <iostream>
+#include <fstream>
 
-void Instance::load(const string &filename)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Retorna o índice denso de um id do XML, criando um novo se necessário
+static int intern(const string &id, unordered_map<string, int> &index, vector<string> &ids)
+{
+    auto it = index.find(id);
+    if (it != index.end())
+        return it->second;
+
+    int idx = ids.size();
+    index[id] = idx;
+    ids.push_back(id);
+    return idx;
+}
+
+namespace
+{
+    // streambuf só de leitura sobre um bloco de memória (o arquivo mapeado), sem cópia
+    class MemoryBuffer : public streambuf
+    {
+    public:
+        MemoryBuffer(const char *data, size_t size)
+        {
+            char *begin = const_cast<char *>(data);
+            setg(begin, begin, begin + size);
+        }
+    };
+}
+
+bool Instance::load(const string &filename, bool use_cache)
 {
-    XMLDocument doc;
-    if (doc.LoadFile(filename.c_str()) != XML_SUCCESS)
+    // Sem cache, o XML é lido em fluxo e a leitura para depois da primeira instância
+    if (!use_cache)
     {
+        ifstream file(filename, ios::binary);
+        if (!file)
+        {
+            cerr << "Erro ao carregar o arquivo XML: " << filename << endl;
+            return false;
+        }
+        return parse(file, filename);
+    }
+
+    // Com cache, o hash precisa do arquivo inteiro: ele é mapeado, hasheado e, se o cache
+    // não servir, lido direto do mapeamento
+    int fd = open(filename.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0)
+    {
+        if (fd >= 0)
+            close(fd);
         cerr << "Erro ao carregar o arquivo XML: " << filename << endl;
-        return;
+        return false;
     }
 
-    XMLElement *root = doc.FirstChildElement("HighSchoolTimetableArchive");
-    if (!root)
+    size_t size = st.st_size;
+    void *mapped = size ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : nullptr;
+    close(fd);
+    if (mapped == MAP_FAILED)
     {
-        cerr << "Elemento raiz não encontrado!" << endl;
-        return;
+        cerr << "Erro ao carregar o arquivo XML: " << filename << endl;
+        return false;
     }
+    const char *data = static_cast<const char *>(mapped);
 
-    XMLElement *instance = root->FirstChildElement("Instances")->FirstChildElement("Instance");
-    if (!instance)
+    string cache_path = filename + ".cache";
+    uint64_t source_hash = InstanceCache::hash(data, size);
+    bool loaded = InstanceCache::read(cache_path, source_hash, *this);
+    if (!loaded)
     {
-        cerr << "Instância não encontrada!" << endl;
-        return;
+        MemoryBuffer buffer(data, size);
+        istream in(&buffer);
+        loaded = parse(in, filename);
+        if (loaded)
+            InstanceCache::write(cache_path, source_hash, *this);
     }
 
-    // Carregar tempos
-    XMLElement *times_elem = instance->FirstChildElement("Times");
-    int time_count = 0;
-    for (XMLElement *time_elem = times_elem->FirstChildElement("Time"); time_elem; time_elem = time_elem->NextSiblingElement("Time"))
+    if (mapped)
+        munmap(mapped, size);
+    return loaded;
+}
+
+bool Instance::parse(istream &in, const string &filename)
+{
+    XmlReader reader(in);
+    bool found_root = false;
+    bool found_instance = false;
+
+    // Só a primeira Instance interessa; o resto do arquivo (ex.: SolutionGroups) nem é lido
+    while (!found_instance && reader.next_child())
     {
-        TimeInfo t;
-        t.id = time_elem->Attribute("Id");
+        if (reader.name() != "HighSchoolTimetableArchive")
+        {
+            reader.skip();
+            continue;
+        }
+        found_root = true;
 
-        // Obter dia
-        XMLElement *day_elem = time_elem->FirstChildElement("Day");
-        if (day_elem)
+        while (!found_instance && reader.next_child())
         {
-            t.day = day_elem->Attribute("Reference");
-            if (t.day.find("gr_") == 0)
+            if (reader.name() != "Instances")
             {
-                t.day = t.day.substr(3); // Remover "gr_"
+                reader.skip();
+                continue;
             }
-        }
 
-        // Obter slot
-        XMLElement *name_elem = time_elem->FirstChildElement("Name");
-        if (name_elem && name_elem->GetText())
-        {
-            string name = name_elem->GetText();
-            size_t pos = name.find('_');
-            if (pos != string::npos)
+            while (!found_instance && reader.next_child())
             {
-                t.slot = stoi(name.substr(pos + 1));
+                if (reader.name() != "Instance")
+                {
+                    reader.skip();
+                    continue;
+                }
+                found_instance = true;
+                id = reader.attribute("Id") ? reader.attribute("Id") : "";
+                if (!parse_instance(reader))
+                    return false;
             }
         }
+    }
+
+    if (reader.failed())
+    {
+        cerr << "Erro ao carregar o arquivo XML: " << filename << endl;
+        return false;
+    }
+
+    if (!found_root)
+    {
+        cerr << "Elemento raiz não encontrado!" << endl;
+        return false;
+    }
+
+    if (!found_instance)
+    {
+        cerr << "Instância não encontrada!" << endl;
+        return false;
+    }
+
+    compile_tables();
+    return true;
+}
+
+bool Instance::parse_instance(XmlReader &reader)
+{
+    while (reader.next_child())
+    {
+        const string &section = reader.name();
+        if (section == "Times")
+        {
+            if (!parse_times(reader))
+                return false;
+        }
+        else if (section == "Resources")
+            parse_resources(reader);
+        else if (section == "Events")
+            parse_events(reader);
+        else if (section == "Constraints")
+            parse_constraints(reader);
+        else
+            reader.skip();
+    }
+
+    if (times.size() > 64)
+    {
+        cerr << "Número de horários maior que 64 não suportado: " << times.size() << endl;
+        return false;
+    }
+
+    // Cada aula ocupa um professor e uma turma; as tabelas da solução são indexadas por eles
+    for (const EventInfo &e : events)
+    {
+        if (e.teacher_id < 0 || e.class_id < 0)
+        {
+            cerr << "Evento sem professor ou turma não suportado: " << e.id << endl;
+            return false;
+        }
+    }
+    return !reader.failed();
+}
 
-        // Verificar duração máxima
+bool Instance::parse_times(XmlReader &reader)
+{
+    while (reader.next_child())
+    {
+        if (reader.name() != "Time")
+        {
+            reader.skip();
+            continue;
+        }
+
+        TimeInfo t;
+        t.id = reader.attribute("Id") ? reader.attribute("Id") : "";
+        t.index = times.size();
+        t.day = -1;
+        t.slot = 0;
         t.max_duration = 1;
-        XMLElement *timeGroups = time_elem->FirstChildElement("TimeGroups");
-        if (timeGroups)
+
+        while (reader.next_child())
         {
-            XMLElement *tg = timeGroups->FirstChildElement("TimeGroup");
-            while (tg)
+            const string &field = reader.name();
+            if (field == "Day" && reader.attribute("Reference"))
+            {
+                // Obter dia
+                string day = reader.attribute("Reference");
+                if (day.find("gr_") == 0)
+                {
+                    day = day.substr(3); // Remover "gr_"
+                }
+                t.day = intern(day, day_index, days);
+                reader.skip();
+            }
+            else if (field == "Name")
+            {
+                // Obter slot
+                string name = reader.read_text();
+                size_t pos = name.find('_');
+                if (pos != string::npos)
+                {
+                    t.slot = stoi(name.substr(pos + 1));
+                }
+            }
+            else if (field == "TimeGroups")
             {
-                if (tg->Attribute("Reference") && string(tg->Attribute("Reference")) == "gr_TimesDurationTwo")
+                // Verificar duração máxima
+                while (reader.next_child())
                 {
-                    t.max_duration = 2;
-                    break;
+                    const char *ref = reader.attribute("Reference");
+                    if (reader.name() == "TimeGroup" && ref && string(ref) == "gr_TimesDurationTwo")
+                    {
+                        t.max_duration = 2;
+                    }
+                    reader.skip();
                 }
-                tg = tg->NextSiblingElement("TimeGroup");
             }
+            else
+            {
+                reader.skip();
+            }
+        }
+
+        if (t.slot < 0 || t.slot >= 64)
+        {
+            cerr << "Slot fora do intervalo [0, 64): " << t.id << endl;
+            return false;
+        }
+
+        // As tabelas da solução são indexadas pelo dia
+        if (t.day < 0)
+        {
+            cerr << "Horário sem dia (<Day>) não suportado: " << t.id << endl;
+            return false;
         }
 
+        time_index[t.id] = t.index;
         times.push_back(t);
-        time_index[t.id] = time_count++;
     }
+    return true;
+}
 
-    // Carregar recursos
-    XMLElement *resources_elem = instance->FirstChildElement("Resources");
-    for (XMLElement *res_elem = resources_elem->FirstChildElement("Resource"); res_elem; res_elem = res_elem->NextSiblingElement("Resource"))
+void Instance::parse_resources(XmlReader &reader)
+{
+    while (reader.next_child())
     {
-        ResourceInfo r;
-        r.id = res_elem->Attribute("Id");
-
-        XMLElement *name_elem = res_elem->FirstChildElement("Name");
-        if (name_elem && name_elem->GetText())
+        if (reader.name() != "Resource")
         {
-            r.name = name_elem->GetText();
+            reader.skip();
+            continue;
         }
 
-        XMLElement *type_elem = res_elem->FirstChildElement("ResourceType");
-        if (type_elem && type_elem->Attribute("Reference"))
+        ResourceInfo r;
+        r.id = reader.attribute("Id") ? reader.attribute("Id") : "";
+
+        while (reader.next_child())
         {
-            r.type = type_elem->Attribute("Reference");
+            if (reader.name() == "Name")
+            {
+                r.name = reader.read_text();
+            }
+            else if (reader.name() == "ResourceType")
+            {
+                if (reader.attribute("Reference"))
+                    r.type = reader.attribute("Reference");
+                reader.skip();
+            }
+            else
+            {
+                reader.skip();
+            }
         }
 
-        resources.push_back(r);
-
         if (r.type == "Teacher")
         {
-            teacher_name[r.id] = r.name;
+            r.index = intern(r.id, teacher_index, teachers);
+        }
+        else if (r.type == "Class")
+        {
+            r.index = intern(r.id, class_index, classes);
         }
+
+        resources.push_back(r);
     }
+}
 
-    // Carregar eventos
-    XMLElement *events_elem = instance->FirstChildElement("Events");
-    int event_count = 0;
-    for (XMLElement *event_elem = events_elem->FirstChildElement("Event"); event_elem; event_elem = event_elem->NextSiblingElement("Event"))
+void Instance::parse_events(XmlReader &reader)
+{
+    while (reader.next_child())
     {
-        EventInfo e;
-        e.id = event_elem->Attribute("Id");
-
-        XMLElement *duration_elem = event_elem->FirstChildElement("Duration");
-        if (duration_elem && duration_elem->GetText())
+        if (reader.name() != "Event")
         {
-            e.total_duration = atoi(duration_elem->GetText());
+            reader.skip();
+            continue;
         }
 
-        XMLElement *course_elem = event_elem->FirstChildElement("Course");
-        if (course_elem && course_elem->Attribute("Reference"))
-        {
-            e.course_id = course_elem->Attribute("Reference");
-        }
+        EventInfo e;
+        e.id = reader.attribute("Id") ? reader.attribute("Id") : "";
+        e.index = events.size();
 
-        // Obter recursos (professor e turma)
-        XMLElement *resources = event_elem->FirstChildElement("Resources");
-        if (resources)
+        while (reader.next_child())
         {
-            for (XMLElement *res_elem = resources->FirstChildElement("Resource"); res_elem; res_elem = res_elem->NextSiblingElement("Resource"))
+            const string &field = reader.name();
+            if (field == "Duration")
             {
-                XMLElement *role_elem = res_elem->FirstChildElement("Role");
-                if (role_elem && role_elem->GetText())
+                e.total_duration = atoi(reader.read_text().c_str());
+            }
+            else if (field == "Course")
+            {
+                if (reader.attribute("Reference"))
+                    e.course_id = intern(reader.attribute("Reference"), course_index, courses);
+                reader.skip();
+            }
+            else if (field == "Resources")
+            {
+                // Obter recursos (professor e turma)
+                while (reader.next_child())
                 {
-                    string role = role_elem->GetText();
-                    string res_id = res_elem->Attribute("Reference");
+                    if (reader.name() != "Resource")
+                    {
+                        reader.skip();
+                        continue;
+                    }
+
+                    string res_id = reader.attribute("Reference") ? reader.attribute("Reference") : "";
+                    string role;
+                    while (reader.next_child())
+                    {
+                        if (reader.name() == "Role")
+                            role = reader.read_text();
+                        else
+                            reader.skip();
+                    }
 
                     if (role == "Teacher")
-                        e.teacher_id = res_id;
+                        e.teacher_id = intern(res_id, teacher_index, teachers);
                     else if (role == "Class")
-                        e.class_id = res_id;
+                        e.class_id = intern(res_id, class_index, classes);
                 }
             }
+            else
+            {
+                reader.skip();
+            }
         }
 
+        event_index[e.id] = e.index;
         events.push_back(e);
-        event_index[e.id] = event_count++;
     }
+}
 
-    // Carregar restrições
-    XMLElement *constraints_elem = instance->FirstChildElement("Constraints");
-    for (XMLElement *constr_elem = constraints_elem->FirstChildElement(); constr_elem; constr_elem = constr_elem->NextSiblingElement())
+void Instance::parse_constraints(XmlReader &reader)
+{
+    // Lê os filhos de um grupo (ex.: <Resources>) e devolve a Reference de cada <item>
+    auto read_references = [&](const string &item)
     {
-        ConstraintInfo c;
-        c.type = constr_elem->Value();
-
-        XMLElement *required_elem = constr_elem->FirstChildElement("Required");
-        if (required_elem && required_elem->GetText())
+        vector<string> refs;
+        while (reader.next_child())
         {
-            c.required = (string(required_elem->GetText()) == "true");
+            if (reader.name() == item && reader.attribute("Reference"))
+                refs.push_back(reader.attribute("Reference"));
+            reader.skip();
         }
+        return refs;
+    };
 
-        XMLElement *weight_elem = constr_elem->FirstChildElement("Weight");
-        if (weight_elem && weight_elem->GetText())
-        {
-            c.weight = atoi(weight_elem->GetText());
-        }
+    while (reader.next_child())
+    {
+        ConstraintInfo c;
+        c.type = ConstraintInfo::parse_type(reader.name());
+        int minimum = 0;
+        int maximum = 0;
+        int duration = 0;
 
-        // Aplicação da restrição
-        XMLElement *applies_to = constr_elem->FirstChildElement("AppliesTo");
-        if (applies_to)
+        while (reader.next_child())
         {
-            // Eventos
-            XMLElement *event_groups = applies_to->FirstChildElement("EventGroups");
-            if (event_groups)
+            const string &field = reader.name();
+            if (field == "Required")
             {
-                for (XMLElement *eg = event_groups->FirstChildElement("EventGroup"); eg; eg = eg->NextSiblingElement("EventGroup"))
-                {
-                    if (eg->Attribute("Reference"))
-                    {
-                        c.applies_to_events.insert(eg->Attribute("Reference"));
-                    }
-                }
+                c.required = (reader.read_text() == "true");
             }
-
-            // Professores
-            XMLElement *teachers = applies_to->FirstChildElement("Resources");
-            if (teachers)
+            else if (field == "Weight")
             {
-                for (XMLElement *t = teachers->FirstChildElement("Resource"); t; t = t->NextSiblingElement("Resource"))
-                {
-                    if (t->Attribute("Reference"))
-                    {
-                        c.applies_to_teachers.insert(t->Attribute("Reference"));
-                    }
-                }
+                c.weight = atoi(reader.read_text().c_str());
             }
-
-            // Turmas
-            XMLElement *classes = applies_to->FirstChildElement("ResourceGroups");
-            if (classes)
+            else if (field == "AppliesTo")
             {
-                for (XMLElement *cl = classes->FirstChildElement("ResourceGroup"); cl; cl = cl->NextSiblingElement("ResourceGroup"))
+                // Aplicação da restrição
+                while (reader.next_child())
                 {
-                    if (cl->Attribute("Reference"))
+                    const string &group = reader.name();
+                    if (group == "EventGroups")
+                    {
+                        for (const string &ref : read_references("EventGroup"))
+                        {
+                            if (course_index.count(ref))
+                                c.applies_to_courses.push_back(course_index.at(ref));
+                        }
+                    }
+                    else if (group == "Resources")
                     {
-                        c.applies_to_classes.insert(cl->Attribute("Reference"));
+                        for (const string &ref : read_references("Resource"))
+                        {
+                            if (teacher_index.count(ref))
+                                c.applies_to_teachers.push_back(teacher_index.at(ref));
+                        }
+                    }
+                    else if (group == "ResourceGroups")
+                    {
+                        c.applies_to_groups = read_references("ResourceGroup");
+                    }
+                    else
+                    {
+                        reader.skip();
                     }
                 }
             }
-        }
-
-         // Horários
-        XMLElement *times = constr_elem->FirstChildElement("Times");
-        if (times)
-        {
-            for (XMLElement *tm = times->FirstChildElement("Time"); tm; tm = tm->NextSiblingElement("Time"))
+            else if (field == "Times")
             {
-                if (tm->Attribute("Reference"))
+                // Horários
+                for (const string &ref : read_references("Time"))
                 {
-                    c.applies_to_times.insert(tm->Attribute("Reference"));
+                    if (time_index.count(ref))
+                        c.applies_to_times.push_back(time_index.at(ref));
                 }
             }
-        }
-
-        // Parâmetros específicos
-        if (c.type == string("DistributeSplitEventsConstraint"))
-        {
-            XMLElement *duration_elem = constr_elem->FirstChildElement("Duration");
-            if (duration_elem && duration_elem->GetText())
+            else if (field == "Duration")
             {
-                c.duration_constraint = atoi(duration_elem->GetText());
+                duration = atoi(reader.read_text().c_str());
             }
-
-            XMLElement *min_elem = constr_elem->FirstChildElement("Minimum");
-            if (min_elem && min_elem->GetText())
+            else if (field == "Minimum")
             {
-                c.min_value = atoi(min_elem->GetText());
+                minimum = atoi(reader.read_text().c_str());
             }
-
-            XMLElement *max_elem = constr_elem->FirstChildElement("Maximum");
-            if (max_elem && max_elem->GetText())
+            else if (field == "Maximum")
             {
-                c.max_value = atoi(max_elem->GetText());
+                maximum = atoi(reader.read_text().c_str());
             }
-
-            for (const string &course_id : c.applies_to_events)
+            else
             {
-                course_split_constraints[course_id] = make_pair(c.min_value, c.max_value);
+                reader.skip();
             }
         }
-        else if (c.type == string("ClusterBusyTimesConstraint"))
+
+        // Parâmetros específicos
+        if (c.type == ConstraintInfo::DISTRIBUTE_SPLIT_EVENTS)
         {
-            XMLElement *min_elem = constr_elem->FirstChildElement("Minimum");
-            if (min_elem && min_elem->GetText())
-            {
-                c.min_value = atoi(min_elem->GetText());
-            }
+            c.duration_constraint = duration;
+            c.min_value = minimum;
+            c.max_value = maximum;
+        }
+        else if (c.type == ConstraintInfo::CLUSTER_BUSY_TIMES)
+        {
+            c.min_value = minimum;
+            c.max_value = maximum;
+        }
+
+        constraints.push_back(c);
+    }
+}
+
+void Instance::compile_tables()
+{
+    teacher_events.assign(teachers.size(), vector<int>());
+    class_events.assign(classes.size(), vector<int>());
+    for (const EventInfo &e : events)
+    {
+        if (e.teacher_id >= 0)
+            teacher_events[e.teacher_id].push_back(e.index);
+        if (e.class_id >= 0)
+            class_events[e.class_id].push_back(e.index);
+    }
+
+    teacher_unavailable_times.assign(teachers.size(), vector<bool>(times.size(), false));
+    course_split_constraints.assign(courses.size(), make_pair(-1, -1));
+    course_split_weight.assign(courses.size(), 0);
+    teacher_max_days.assign(teachers.size(), -1);
+    teacher_max_days_weight.assign(teachers.size(), 0);
+    next_time.assign(times.size(), -1);
+    double_starts = 0;
+    has_idle_constraint = false;
+    idle_weight = 1;
+    type_source.assign(ConstraintInfo::UNKNOWN, -1);
+    teacher_unavailable_source.assign(teachers.size(), vector<int>(times.size(), -1));
+    course_split_source.assign(courses.size(), -1);
+    teacher_max_days_source.assign(teachers.size(), -1);
+    idle_source = -1;
+
+    // Nas tabelas por curso/professor vale a última restrição que se aplica; a de janelas é a primeira
+    for (int index = 0; index < (int)constraints.size(); index++)
+    {
+        const ConstraintInfo &c = constraints[index];
+        if (c.type != ConstraintInfo::UNKNOWN && type_source[c.type] < 0)
+            type_source[c.type] = index;
 
-            XMLElement *max_elem = constr_elem->FirstChildElement("Maximum");
-            if (max_elem && max_elem->GetText())
+        if (c.type == ConstraintInfo::DISTRIBUTE_SPLIT_EVENTS)
+        {
+            for (int course_id : c.applies_to_courses)
             {
-                c.max_value = atoi(max_elem->GetText());
+                course_split_constraints[course_id] = make_pair(c.min_value, c.max_value);
+                course_split_weight[course_id] = c.weight;
+                course_split_source[course_id] = index;
             }
-
-            for (const string &teacher_id : c.applies_to_teachers)
+        }
+        else if (c.type == ConstraintInfo::CLUSTER_BUSY_TIMES)
+        {
+            for (int teacher_id : c.applies_to_teachers)
             {
                 teacher_max_days[teacher_id] = c.max_value;
+                teacher_max_days_weight[teacher_id] = c.weight;
+                teacher_max_days_source[teacher_id] = index;
             }
         }
-        else if (c.type == string("AvoidUnavailableTimesConstraint"))
+        else if (c.type == ConstraintInfo::AVOID_UNAVAILABLE_TIMES)
         {
-            for (const string &teacher_id : c.applies_to_teachers)
+            for (int teacher_id : c.applies_to_teachers)
             {
-                for (const string &time_id : c.applies_to_times)
+                for (int time_id : c.applies_to_times)
                 {
-                    teacher_unavailable_times[teacher_id].insert(time_id);
-
-                    // cout << "---------- START DEBUG ----------" << endl;
-                    // cout << "teacher_id: " << teacher_id << endl;
-                    // cout << "time_id: " << time_id << endl;
-                    // cout << "---------- END DEBUG ----------" << endl;
-
+                    teacher_unavailable_times[teacher_id][time_id] = true;
+                    teacher_unavailable_source[teacher_id][time_id] = index;
                 }
             }
         }
-
-        constraints.push_back(c);
+        else if (c.type == ConstraintInfo::LIMIT_IDLE_TIMES && !has_idle_constraint)
+        {
+            idle_weight = c.weight;
+            idle_source = index;
+            has_idle_constraint = true;
+        }
     }
-    
-    unordered_map<string, vector<TimeInfo>> times_by_day;
+
+    vector<vector<TimeInfo>> times_by_day(days.size());
     for (const TimeInfo &t : times) {
-        times_by_day[t.day].push_back(t);
+        if (t.day >= 0)
+            times_by_day[t.day].push_back(t);
     }
 
-    for (auto &pair : times_by_day) {
-        vector<TimeInfo> &times_in_day = pair.second;
+    for (auto &times_in_day : times_by_day) {
         sort(times_in_day.begin(), times_in_day.end(), 
             [](const TimeInfo &a, const TimeInfo &b) { 
                 return a.slot < b.slot; 
             });
 
         for (int i = 0; i < (int)times_in_day.size() - 1; i++) {
-            next_time[times_in_day[i].id] = times_in_day[i+1].id;
+            next_time[times_in_day[i].index] = times_in_day[i+1].index;
         }
     }
 
-}
\ No newline at end of file
+    for (const TimeInfo &t : times) {
+        if (t.max_duration >= 2 && next_time[t.index] == t.index + 1)
+            double_starts |= 1ULL << t.index;
+    }
+
+    // Candidatos estáticos de cada evento: disponibilidade do professor e aulas duplas
+    day_times.assign(days.size(), 0);
+    for (const TimeInfo &t : times) {
+        if (t.day >= 0)
+            day_times[t.day] |= 1ULL << t.index;
+    }
+
+    event_single_times.assign(events.size(), 0);
+    event_double_times.assign(events.size(), 0);
+    for (const EventInfo &e : events) {
+        uint64_t available = 0;
+        for (const TimeInfo &t : times) {
+            if (e.teacher_id < 0 || !teacher_unavailable_times[e.teacher_id][t.index])
+                available |= 1ULL << t.index;
+        }
+        event_single_times[e.index] = available;
+        event_double_times[e.index] = available & double_starts;
+    }
+}
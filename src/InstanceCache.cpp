@@ -0,0 +1,478 @@
+#include "../include/InstanceCache.h"
+
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    const char MAGIC[8] = {'X', 'H', 'S', 'T', 'T', 'B', 'I', 'N'};
+
+    class Header
+    {
+    public:
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t source_hash;
+        uint64_t strings_offset; // início da tabela de strings, a partir do começo do arquivo
+    };
+
+    // Serializa campos POD e vetores densos; strings viram índices numa tabela única
+    class Writer
+    {
+    public:
+        vector<char> body;
+        vector<string> strings;
+        unordered_map<string, uint32_t> string_ids;
+
+        template <class T>
+        void pod(const T &value)
+        {
+            static_assert(is_trivially_copyable<T>::value, "pod exige tipo trivialmente copiável");
+            const char *bytes = reinterpret_cast<const char *>(&value);
+            body.insert(body.end(), bytes, bytes + sizeof(T));
+        }
+
+        template <class T>
+        void array(const vector<T> &values)
+        {
+            static_assert(is_trivially_copyable<T>::value, "array exige tipo trivialmente copiável");
+            pod<uint32_t>(values.size());
+            const char *bytes = reinterpret_cast<const char *>(values.data());
+            body.insert(body.end(), bytes, bytes + values.size() * sizeof(T));
+        }
+
+        void str(const string &value)
+        {
+            auto it = string_ids.find(value);
+            if (it == string_ids.end())
+            {
+                it = string_ids.emplace(value, strings.size()).first;
+                strings.push_back(value);
+            }
+            pod<uint32_t>(it->second);
+        }
+
+        void strs(const vector<string> &values)
+        {
+            pod<uint32_t>(values.size());
+            for (const string &value : values)
+            {
+                str(value);
+            }
+        }
+
+        void nested(const vector<vector<int>> &values)
+        {
+            pod<uint32_t>(values.size());
+            for (const vector<int> &inner : values)
+            {
+                array(inner);
+            }
+        }
+    };
+
+    // Lê o formato do Writer direto da memória mapeada; qualquer leitura fora dos limites invalida
+    class Reader
+    {
+    public:
+        const char *data;
+        size_t size;
+        size_t pos;
+        vector<string> strings;
+        bool ok = true;
+
+        Reader(const char *data, size_t size, size_t pos) : data(data), size(size), pos(pos) {}
+
+        bool take(size_t bytes)
+        {
+            if (!ok || bytes > size - pos)
+            {
+                ok = false;
+                return false;
+            }
+            pos += bytes;
+            return true;
+        }
+
+        template <class T>
+        T pod()
+        {
+            T value{};
+            size_t at = pos;
+            if (take(sizeof(T)))
+                memcpy(&value, data + at, sizeof(T));
+            return value;
+        }
+
+        template <class T>
+        void array(vector<T> &values)
+        {
+            uint32_t n = pod<uint32_t>();
+            size_t at = pos;
+            if (!ok || !take((size_t)n * sizeof(T)))
+                return;
+            values.resize(n);
+            if (n)
+                memcpy(values.data(), data + at, (size_t)n * sizeof(T));
+        }
+
+        string str()
+        {
+            uint32_t id = pod<uint32_t>();
+            if (!ok || id >= strings.size())
+            {
+                ok = false;
+                return string();
+            }
+            return strings[id];
+        }
+
+        void strs(vector<string> &values)
+        {
+            uint32_t n = pod<uint32_t>();
+            values.clear();
+            for (uint32_t i = 0; i < n && ok; i++)
+            {
+                values.push_back(str());
+            }
+        }
+
+        void nested(vector<vector<int>> &values)
+        {
+            uint32_t n = pod<uint32_t>();
+            values.clear();
+            for (uint32_t i = 0; i < n && ok; i++)
+            {
+                values.emplace_back();
+                array(values.back());
+            }
+        }
+
+        void read_strings()
+        {
+            uint32_t n = pod<uint32_t>();
+            for (uint32_t i = 0; i < n && ok; i++)
+            {
+                uint32_t length = pod<uint32_t>();
+                size_t at = pos;
+                if (take(length))
+                    strings.emplace_back(data + at, length);
+            }
+        }
+    };
+
+    void rebuild_index(const vector<string> &ids, unordered_map<string, int> &index)
+    {
+        index.clear();
+        index.reserve(ids.size());
+        for (int i = 0; i < (int)ids.size(); i++)
+        {
+            index[ids[i]] = i;
+        }
+    }
+}
+
+uint64_t InstanceCache::hash(const char *data, size_t size)
+{
+    uint64_t h = 1469598103934665603ULL;
+    for (size_t i = 0; i < size; i++)
+    {
+        h ^= (unsigned char)data[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+bool InstanceCache::write(const string &path, uint64_t source_hash, const Instance &instance)
+{
+    Writer w;
+
+    w.str(instance.id);
+    w.strs(instance.days);
+    w.strs(instance.teachers);
+    w.strs(instance.classes);
+    w.strs(instance.courses);
+
+    w.pod<uint32_t>(instance.times.size());
+    for (const TimeInfo &t : instance.times)
+    {
+        w.str(t.id);
+        w.pod<int32_t>(t.day);
+        w.pod<int32_t>(t.slot);
+        w.pod<int32_t>(t.max_duration);
+    }
+
+    w.pod<uint32_t>(instance.resources.size());
+    for (const ResourceInfo &r : instance.resources)
+    {
+        w.str(r.id);
+        w.str(r.name);
+        w.str(r.type);
+        w.pod<int32_t>(r.index);
+    }
+
+    w.pod<uint32_t>(instance.events.size());
+    for (const EventInfo &e : instance.events)
+    {
+        w.str(e.id);
+        w.pod<int32_t>(e.total_duration);
+        w.pod<int32_t>(e.course_id);
+        w.pod<int32_t>(e.teacher_id);
+        w.pod<int32_t>(e.class_id);
+    }
+
+    w.pod<uint32_t>(instance.constraints.size());
+    for (const ConstraintInfo &c : instance.constraints)
+    {
+        w.pod<int32_t>(c.type);
+        w.pod<uint8_t>(c.required);
+        w.pod<int32_t>(c.weight);
+        w.array(c.applies_to_courses);
+        w.array(c.applies_to_teachers);
+        w.strs(c.applies_to_groups);
+        w.array(c.applies_to_times);
+        w.pod<int32_t>(c.min_value);
+        w.pod<int32_t>(c.max_value);
+        w.pod<int32_t>(c.duration_constraint);
+    }
+
+    // Tabelas compiladas
+    w.nested(instance.teacher_events);
+    w.nested(instance.class_events);
+
+    w.pod<uint32_t>(instance.teacher_unavailable_times.size());
+    for (const vector<bool> &row : instance.teacher_unavailable_times)
+    {
+        w.array(vector<uint8_t>(row.begin(), row.end()));
+    }
+
+    vector<int32_t> split_limits;
+    for (const auto &limits : instance.course_split_constraints)
+    {
+        split_limits.push_back(limits.first);
+        split_limits.push_back(limits.second);
+    }
+    w.array(split_limits);
+    w.array(instance.course_split_weight);
+    w.array(instance.teacher_max_days);
+    w.array(instance.teacher_max_days_weight);
+    w.pod<uint8_t>(instance.has_idle_constraint);
+    w.pod<int32_t>(instance.idle_weight);
+    w.array(instance.type_source);
+    w.nested(instance.teacher_unavailable_source);
+    w.array(instance.course_split_source);
+    w.array(instance.teacher_max_days_source);
+    w.pod<int32_t>(instance.idle_source);
+    w.array(instance.next_time);
+    w.pod<uint64_t>(instance.double_starts);
+    w.array(instance.day_times);
+    w.array(instance.event_single_times);
+    w.array(instance.event_double_times);
+
+    Header header;
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.reserved = 0;
+    header.source_hash = source_hash;
+    header.strings_offset = sizeof(Header) + w.body.size();
+
+    // Tabela de strings no fim: contagem, depois (tamanho, bytes) de cada uma
+    vector<char> table;
+    auto put = [&](uint32_t value)
+    {
+        const char *bytes = reinterpret_cast<const char *>(&value);
+        table.insert(table.end(), bytes, bytes + sizeof(value));
+    };
+    put(w.strings.size());
+    for (const string &s : w.strings)
+    {
+        put(s.size());
+        table.insert(table.end(), s.begin(), s.end());
+    }
+
+    string tmp_path = path + ".tmp." + to_string(getpid());
+    {
+        ofstream out(tmp_path, ios::binary | ios::trunc);
+        if (!out)
+            return false;
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(w.body.data(), w.body.size());
+        out.write(table.data(), table.size());
+        if (!out)
+        {
+            out.close();
+            remove(tmp_path.c_str());
+            return false;
+        }
+    }
+
+    if (rename(tmp_path.c_str(), path.c_str()) != 0)
+    {
+        remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool InstanceCache::read(const string &path, uint64_t source_hash, Instance &instance)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(Header))
+    {
+        close(fd);
+        return false;
+    }
+
+    size_t size = st.st_size;
+    void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+        return false;
+
+    const char *data = static_cast<const char *>(mapped);
+    Header header;
+    memcpy(&header, data, sizeof(header));
+
+    bool valid = memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+                 header.version == VERSION &&
+                 header.source_hash == source_hash &&
+                 header.strings_offset >= sizeof(Header) && header.strings_offset <= size;
+    if (!valid)
+    {
+        munmap(mapped, size);
+        return false;
+    }
+
+    Reader r(data, size, header.strings_offset);
+    r.read_strings();
+    r.pos = sizeof(Header);
+    r.size = header.strings_offset;
+
+    Instance loaded;
+
+    loaded.id = r.str();
+    r.strs(loaded.days);
+    r.strs(loaded.teachers);
+    r.strs(loaded.classes);
+    r.strs(loaded.courses);
+
+    uint32_t num_times = r.pod<uint32_t>();
+    for (uint32_t i = 0; i < num_times && r.ok; i++)
+    {
+        TimeInfo t;
+        t.id = r.str();
+        t.index = i;
+        t.day = r.pod<int32_t>();
+        t.slot = r.pod<int32_t>();
+        t.max_duration = r.pod<int32_t>();
+        loaded.times.push_back(t);
+    }
+
+    uint32_t num_resources = r.pod<uint32_t>();
+    for (uint32_t i = 0; i < num_resources && r.ok; i++)
+    {
+        ResourceInfo res;
+        res.id = r.str();
+        res.name = r.str();
+        res.type = r.str();
+        res.index = r.pod<int32_t>();
+        loaded.resources.push_back(res);
+    }
+
+    uint32_t num_events = r.pod<uint32_t>();
+    for (uint32_t i = 0; i < num_events && r.ok; i++)
+    {
+        EventInfo e;
+        e.id = r.str();
+        e.index = i;
+        e.total_duration = r.pod<int32_t>();
+        e.course_id = r.pod<int32_t>();
+        e.teacher_id = r.pod<int32_t>();
+        e.class_id = r.pod<int32_t>();
+        loaded.events.push_back(e);
+    }
+
+    uint32_t num_constraints = r.pod<uint32_t>();
+    for (uint32_t i = 0; i < num_constraints && r.ok; i++)
+    {
+        ConstraintInfo c;
+        c.type = static_cast<ConstraintInfo::Type>(r.pod<int32_t>());
+        c.required = r.pod<uint8_t>() != 0;
+        c.weight = r.pod<int32_t>();
+        r.array(c.applies_to_courses);
+        r.array(c.applies_to_teachers);
+        r.strs(c.applies_to_groups);
+        r.array(c.applies_to_times);
+        c.min_value = r.pod<int32_t>();
+        c.max_value = r.pod<int32_t>();
+        c.duration_constraint = r.pod<int32_t>();
+        loaded.constraints.push_back(c);
+    }
+
+    r.nested(loaded.teacher_events);
+    r.nested(loaded.class_events);
+
+    uint32_t num_rows = r.pod<uint32_t>();
+    for (uint32_t i = 0; i < num_rows && r.ok; i++)
+    {
+        vector<uint8_t> row;
+        r.array(row);
+        loaded.teacher_unavailable_times.emplace_back(row.begin(), row.end());
+    }
+
+    vector<int32_t> split_limits;
+    r.array(split_limits);
+    for (size_t i = 0; i + 1 < split_limits.size(); i += 2)
+    {
+        loaded.course_split_constraints.push_back(make_pair(split_limits[i], split_limits[i + 1]));
+    }
+    r.array(loaded.course_split_weight);
+    r.array(loaded.teacher_max_days);
+    r.array(loaded.teacher_max_days_weight);
+    loaded.has_idle_constraint = r.pod<uint8_t>() != 0;
+    loaded.idle_weight = r.pod<int32_t>();
+    r.array(loaded.type_source);
+    r.nested(loaded.teacher_unavailable_source);
+    r.array(loaded.course_split_source);
+    r.array(loaded.teacher_max_days_source);
+    loaded.idle_source = r.pod<int32_t>();
+    r.array(loaded.next_time);
+    loaded.double_starts = r.pod<uint64_t>();
+    r.array(loaded.day_times);
+    r.array(loaded.event_single_times);
+    r.array(loaded.event_double_times);
+
+    bool ok = r.ok && r.pos == r.size;
+    munmap(mapped, size);
+    if (!ok)
+        return false;
+
+    // Os mapas id -> índice são reconstruídos a partir das listas densas
+    vector<string> time_ids, event_ids;
+    for (const TimeInfo &t : loaded.times)
+        time_ids.push_back(t.id);
+    for (const EventInfo &e : loaded.events)
+        event_ids.push_back(e.id);
+
+    rebuild_index(time_ids, loaded.time_index);
+    rebuild_index(event_ids, loaded.event_index);
+    rebuild_index(loaded.days, loaded.day_index);
+    rebuild_index(loaded.teachers, loaded.teacher_index);
+    rebuild_index(loaded.classes, loaded.class_index);
+    rebuild_index(loaded.courses, loaded.course_index);
+
+    instance = move(loaded);
+    return true;
+}
@@ -0,0 +1,246 @@
+#include "../include/IslandModel.h"
+#include "../include/IncrementalEvaluator.h"
+#include "../include/CompactSolution.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+IslandModel::IslandModel(Instance &instance, int num_islands, RngStream rng, int max_restarts)
+    : instance(instance), num_islands(max(1, num_islands)), rng(rng), max_restarts(max_restarts) {}
+
+void IslandModel::seed(uint64_t value)
+{
+    rng = RngStream(value);
+}
+
+vector<int> IslandModel::neighbors(int island) const
+{
+    vector<int> result;
+    if (num_islands < 2)
+        return result;
+
+    if (topology == RING)
+    {
+        result.push_back((island + 1) % num_islands);
+        return result;
+    }
+
+    for (int other = 0; other < num_islands; other++)
+    {
+        if (other != island)
+            result.push_back(other);
+    }
+    return result;
+}
+
+vector<uint8_t> IslandModel::encode(const Instance &instance, const Solution &solution)
+{
+    CompactSolution compact;
+    if (!compact.assign(instance, solution))
+        return {};
+
+    const uint8_t *begin = reinterpret_cast<const uint8_t *>(&compact);
+    return vector<uint8_t>(begin, begin + compact.used_bytes());
+}
+
+bool IslandModel::decode(const Instance &instance, const vector<uint8_t> &bytes, Solution &solution)
+{
+    const size_t header = offsetof(CompactSolution, lessons);
+    if (bytes.size() < header)
+        return false;
+
+    CompactSolution compact;
+    memcpy(&compact.num_lessons, bytes.data() + offsetof(CompactSolution, num_lessons), sizeof(uint16_t));
+    if (compact.num_lessons > CompactSolution::MAX_LESSONS || bytes.size() != compact.used_bytes())
+        return false;
+    memcpy(compact.lessons, bytes.data() + header, bytes.size() - header);
+
+    for (int i = 0; i < compact.num_lessons; i++)
+    {
+        const CompactSolution::Lesson &lesson = compact.lessons[i];
+        if (lesson.event_id >= instance.events.size() || lesson.duration < 1 ||
+            (lesson.time_id != CompactSolution::UNALLOCATED && lesson.time_id >= instance.times.size()))
+            return false;
+    }
+
+    solution = compact.expand(instance);
+    return true;
+}
+
+Solution IslandModel::solve(int pop_size, int limit, int max_cycles, double destruction_rate, StopCriteria stop)
+{
+    stop.start();
+    // Cópias locais: solve não altera a configuração do objeto
+    const int interval = max(1, migration_interval);
+    const int num_migrants = max(0, migrants);
+
+    vector<unique_ptr<Mailbox>> mailboxes;
+    vector<vector<int>> senders(num_islands); // island -> ilhas que mandam para ela
+    for (int island = 0; island < num_islands; island++)
+    {
+        mailboxes.emplace_back(new Mailbox());
+        mailboxes.back()->closed.assign(num_islands, false);
+    }
+    for (int island = 0; island < num_islands; island++)
+    {
+        for (int receiver : neighbors(island))
+        {
+            senders[receiver].push_back(island);
+        }
+    }
+
+    atomic<bool> done(false); // custo alvo atingido por alguma ilha
+    mutex report_mtx;
+    double global_best = 1e18;
+
+    vector<Solution> results(num_islands);
+    vector<double> result_costs(num_islands, 1e18);
+
+    auto post = [&](int receiver, const Message &message)
+    {
+        Mailbox &box = *mailboxes[receiver];
+        lock_guard<mutex> lock(box.mtx);
+        box.messages.push_back(message);
+        box.arrived.notify_all();
+    };
+
+    // Acorda todas as ilhas que estejam esperando mensagens
+    auto finish_all = [&]()
+    {
+        done = true;
+        for (auto &box : mailboxes)
+        {
+            lock_guard<mutex> lock(box->mtx);
+            box->arrived.notify_all();
+        }
+    };
+
+    auto worker = [&](int island)
+    {
+        BeeColony colony(instance, 1, rng.split(island), max_restarts);
+        colony.verbose = false;
+
+        // O prazo é o que sobra do prazo global
+        StopCriteria island_stop(stop.time_limit < 0 ? -1 : max(0.0, stop.time_limit - stop.elapsed()), stop.target_cost);
+        island_stop.on_improvement = [&](double, double cost)
+        {
+            lock_guard<mutex> lock(report_mtx);
+            if (cost < global_best)
+            {
+                global_best = cost;
+                stop.improved(cost);
+                if (verbose)
+                    cout << "Ilha " << island << ": melhor custo global = " << cost << endl;
+            }
+        };
+
+        Mailbox &box = *mailboxes[island];
+        colony.on_cycle = [&](int cycle)
+        {
+            if (done)
+                return false;
+            if (stop.reached(colony.getBestCost()))
+            {
+                finish_all();
+                return false;
+            }
+            if ((cycle + 1) % interval != 0 || num_islands < 2)
+                return true;
+
+            int epoch = (cycle + 1) / interval;
+
+            Message message;
+            message.sender = island;
+            message.epoch = epoch;
+            for (const Solution &source : colony.best_sources(num_migrants))
+            {
+                message.solutions.push_back(encode(instance, source));
+            }
+            for (int receiver : neighbors(island))
+            {
+                post(receiver, message);
+            }
+
+            // Espera a mensagem da mesma época de cada vizinha que ainda está rodando
+            vector<Message> received;
+            {
+                unique_lock<mutex> lock(box.mtx);
+                box.arrived.wait(lock, [&]()
+                                 {
+                                     if (done)
+                                         return true;
+                                     for (int sender : senders[island])
+                                     {
+                                         bool has = box.closed[sender];
+                                         for (const Message &m : box.messages)
+                                         {
+                                             has |= m.sender == sender && m.epoch == epoch;
+                                         }
+                                         if (!has)
+                                             return false;
+                                     }
+                                     return true;
+                                 });
+
+                // Mensagens de épocas futuras ficam na caixa
+                vector<Message> pending;
+                for (Message &m : box.messages)
+                {
+                    if (m.epoch <= epoch)
+                        received.push_back(move(m));
+                    else
+                        pending.push_back(move(m));
+                }
+                box.messages = move(pending);
+            }
+
+            // Ordem fixa de chegada (por remetente) para o resultado não depender do escalonamento
+            stable_sort(received.begin(), received.end(), [](const Message &a, const Message &b)
+                        { return a.sender < b.sender; });
+            for (const Message &m : received)
+            {
+                for (const vector<uint8_t> &bytes : m.solutions)
+                {
+                    Solution migrant;
+                    if (decode(instance, bytes, migrant))
+                        colony.immigrate(migrant);
+                }
+            }
+            return !done;
+        };
+
+        colony.solve(pop_size, limit, max_cycles, destruction_rate, island_stop);
+
+        // Deixa de ser esperada pelas vizinhas
+        for (int receiver : neighbors(island))
+        {
+            Mailbox &other = *mailboxes[receiver];
+            lock_guard<mutex> lock(other.mtx);
+            other.closed[island] = true;
+            other.arrived.notify_all();
+        }
+
+        results[island] = colony.getBestSolution();
+        result_costs[island] = colony.getBestCost();
+        if (stop.reached(result_costs[island]))
+            finish_all();
+    };
+
+    vector<thread> threads;
+    for (int island = 0; island < num_islands; island++)
+    {
+        threads.emplace_back(worker, island);
+    }
+    for (thread &t : threads)
+    {
+        t.join();
+    }
+
+    int best = min_element(result_costs.begin(), result_costs.end()) - result_costs.begin();
+    return results[best];
+}
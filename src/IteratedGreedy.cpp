@@ -1,52 +1,38 @@
 #include "../include/IteratedGreedy.h"
 
-#include <chrono>
 #include <random>
 #include <algorithm>
-
-vector<string> IteratedGreedy::select_events(const Solution &solution, const Instance &instance, int num_events)
+#include <atomic>
+#include <climits>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+vector<int> IteratedGreedy::select_events(const Solution &solution, const Instance &instance, const IncrementalEvaluator &evaluator,
+                                          int num_events)
 {
-    vector<pair<string, int>> event_costs;
-    for (const auto &e : solution.event_allocations)
+    // Custo mantido de cada evento, mais as violações de dias e janelas do professor
+    // (as de janelas só nos dias em que o evento tem aula)
+    vector<pair<int, int>> event_costs;
+    for (const EventInfo &event : instance.events)
     {
-        const string &event_id = e.first;
-        int cost = 0;
-
-        if (solution.allocated_duration.at(event_id) < instance.events[instance.event_index.at(event_id)].total_duration)
-        {
-            cost += 1000;
-        }
-
-        if (solution.event_day_counts.find(event_id) != solution.event_day_counts.end())
-        {
-            for (const auto &day_count : solution.event_day_counts.at(event_id))
-            {
-                if (day_count.second > 1)
-                {
-                    cost += 50;
-                }
-            }
-        }
+        int event_id = event.index;
+        if (solution.event_allocations[event_id].empty())
+            continue;
 
-        if (instance.course_split_constraints.find(instance.events[instance.event_index.at(event_id)].course_id) != instance.course_split_constraints.end())
+        int cost = evaluator.event_cost(solution, event_id) + evaluator.teacher_days_cost(event.teacher_id);
+        for (int day = 0; day < (int)instance.days.size(); day++)
         {
-            auto constraint = instance.course_split_constraints.at(instance.events[instance.event_index.at(event_id)].course_id);
-            int min_double = constraint.first;
-            int max_double = constraint.second;
-            int actual_double = (solution.event_double_lessons.find(event_id) != solution.event_double_lessons.end()) ? solution.event_double_lessons.at(event_id) : 0;
-            if (actual_double < min_double)
-                cost += (min_double - actual_double) * 10;
-            if (actual_double > max_double)
-                cost += (actual_double - max_double) * 10;
+            if (solution.event_day_counts[event_id][day] > 0)
+                cost += evaluator.teacher_idle_cost(event.teacher_id, day);
         }
-
         event_costs.push_back({event_id, cost});
     }
 
-    sort(event_costs.begin(), event_costs.end(), [](const pair<string, int> &a, const pair<string, int> &b)
+    sort(event_costs.begin(), event_costs.end(), [](const pair<int, int> &a, const pair<int, int> &b)
          { return a.second > b.second; });
 
-    vector<string> selected;
+    vector<int> selected;
     int n = min(num_events, (int)event_costs.size());
     for (int i = 0; i < n; i++)
     {
@@ -55,210 +41,116 @@ vector<string> IteratedGreedy::select_events(const Solution &solution, const Ins
     return selected;
 }
 
-void IteratedGreedy::remove_allocations(string event_id, Solution &solution, const Instance &instance)
+void IteratedGreedy::seed(uint64_t value)
 {
-    if (instance.event_index.find(event_id) == instance.event_index.end())
-        return;
-
-    const EventInfo &event = instance.events.at(instance.event_index.at(event_id));
-
-    auto it = solution.allocations.begin();
-    while (it != solution.allocations.end())
-    {
-        if (it->event_id == event_id)
-        {
-            solution.teacher_occupation[it->time_id].erase(event.teacher_id);
-            solution.class_occupation[it->time_id].erase(event.class_id);
-
-            if (solution.event_day_counts.find(event_id) != solution.event_day_counts.end())
-            {
-                const TimeInfo &t = instance.times.at(instance.time_index.at(it->time_id));
-                auto &day_map = solution.event_day_counts[event_id];
-                if (day_map.find(t.day) != day_map.end())
-                {
-                    day_map[t.day]--;
-                    if (day_map[t.day] == 0)
-                    {
-                        day_map.erase(t.day);
-                    }
-                }
-            }
-
-            if (it->duration == 2)
-            {
-                if (instance.next_time.find(it->time_id) != instance.next_time.end())
-                {
-                    string next_id = instance.next_time.at(it->time_id);
-                    solution.teacher_occupation[next_id].erase(event.teacher_id);
-                    solution.class_occupation[next_id].erase(event.class_id);
-                }
-
-                if (solution.event_double_lessons.find(event_id) != solution.event_double_lessons.end())
-                {
-                    solution.event_double_lessons[event_id]--;
-                    if (solution.event_double_lessons[event_id] == 0)
-                    {
-                        solution.event_double_lessons.erase(event_id);
-                    }
-                }
-            }
-            
-            it = solution.allocations.erase(it);
-        }
-        else
-        {
-            ++it;
-        }
-    }
-
-    solution.event_allocations.erase(event_id);
-    solution.allocated_duration.erase(event_id);
-
-    set<string> days_to_remove;
-    for (const auto &day : solution.teacher_schedule[event.teacher_id])
-    {
-        bool has_other_allocations = false;
-        for (const Allocation &alloc : solution.allocations)
-        {
-            if (alloc.time_id == "UNALLOCATED")
-                continue;
-            const EventInfo &e = instance.events.at(instance.event_index.at(alloc.event_id));
-            if (e.teacher_id == event.teacher_id)
-            {
-                const TimeInfo &t = instance.times.at(instance.time_index.at(alloc.time_id));
-                if (t.day == day)
-                {
-                    has_other_allocations = true;
-                    break;
-                }
-            }
-        }
-        if (!has_other_allocations)
-        {
-            days_to_remove.insert(day);
-        }
-    }
-    for (const auto &day : days_to_remove)
-    {
-        solution.teacher_schedule[event.teacher_id].erase(day);
-    }
-    if (solution.teacher_schedule[event.teacher_id].empty())
-    {
-        solution.teacher_schedule.erase(event.teacher_id);
-    }
+    rng = RngStream(value);
+    greedy.rng = rng.split(0);
+}
 
-    days_to_remove.clear();
-    for (const auto &day : solution.class_schedule[event.class_id])
-    {
-        bool has_other_allocations = false;
-        for (const Allocation &alloc : solution.allocations)
-        {
-            if (alloc.time_id == "UNALLOCATED")
-                continue;
-            const EventInfo &e = instance.events.at(instance.event_index.at(alloc.event_id));
-            if (e.class_id == event.class_id)
-            {
-                const TimeInfo &t = instance.times.at(instance.time_index.at(alloc.time_id));
-                if (t.day == day)
-                {
-                    has_other_allocations = true;
-                    break;
-                }
-            }
-        }
-        if (!has_other_allocations)
-        {
-            days_to_remove.insert(day);
-        }
-    }
-    for (const auto &day : days_to_remove)
-    {
-        solution.class_schedule[event.class_id].erase(day);
-    }
-    if (solution.class_schedule[event.class_id].empty())
-    {
-        solution.class_schedule.erase(event.class_id);
-    }
+void IteratedGreedy::remove_allocations(int event_id, Solution &solution, const Instance &instance)
+{
+    if (event_id < 0 || event_id >= (int)instance.events.size())
+        return;
 
-    if (solution.event_day_counts.find(event_id) != solution.event_day_counts.end() &&
-        solution.event_day_counts[event_id].empty())
+    vector<Allocation> event_allocs = solution.event_allocations[event_id];
+    for (const Allocation &alloc : event_allocs)
     {
-        solution.event_day_counts.erase(event_id);
-    }
-    if (solution.event_double_lessons.find(event_id) != solution.event_double_lessons.end() &&
-        solution.event_double_lessons[event_id] == 0)
-    {
-        solution.event_double_lessons.erase(event_id);
+        solution.remove_allocation(instance, alloc);
     }
 }
 
-pair<Solution, vector<string>> IteratedGreedy::destroy(Solution solution, int destruction_rate, const Instance &instance)
+vector<int> IteratedGreedy::destroy(Solution &solution, const IncrementalEvaluator &evaluator, int destruction_rate, const Instance &instance)
 {
-    vector<string> events_to_destroy = select_events(solution, instance, destruction_rate);
+    vector<int> events_to_destroy = select_events(solution, instance, evaluator, destruction_rate);
 
     for (const auto &event_id : events_to_destroy)
     {
         remove_allocations(event_id, solution, instance);
     }
 
-    return {solution, events_to_destroy};
+    return events_to_destroy;
 }
 
-Solution IteratedGreedy::rebuild(Solution solution, vector<string> &destroyed, Instance &instance)
+void IteratedGreedy::rebuild(Solution &solution, vector<int> &destroyed, Instance &instance)
 {
-    sort(destroyed.begin(), destroyed.end(), [&](const string &a, const string &b)
-         { return instance.events[instance.event_index.at(a)].total_duration >
-                  instance.events[instance.event_index.at(b)].total_duration; });
-
-    Greedy greedy;
-    greedy.generate_greedy(destroyed, solution, instance); 
+    sort(destroyed.begin(), destroyed.end(), [&](int a, int b)
+         { return instance.events[a].total_duration >
+                  instance.events[b].total_duration; });
 
-    return solution;
+    greedy.generate_greedy(destroyed, solution, instance);
 }
 
-Solution IteratedGreedy::solve(Instance &instance, int max_iters, float destruction_percentage)
+Solution IteratedGreedy::solve(Instance &instance, int max_iters, float destruction_percentage, StopCriteria stop)
 {
+    stop.start();
+    visited.clear();
+
     int total_events = instance.events.size();
     int destruction_rate = max(1, static_cast<int>(total_events * destruction_percentage));
 
-    Greedy greedy;
-
     Solution best_solution = greedy.generate_greedy(instance);
     Solution current_solution = best_solution;
 
-    Evaluator evaluator;
-    evaluator.evaluate(instance, best_solution);
-    int best_cost = evaluator.hard_violations * 1000 + evaluator.total_cost; // Corrigido
+    IncrementalEvaluator current_evaluator(instance);
+    current_evaluator.reset(current_solution);
+    int best_cost = current_evaluator.objective();
+    stop.improved(best_cost);
 
-    random_device rd;
-    mt19937 gen(rd());
     uniform_real_distribution<> dis(0.0, 1.0);
 
     double initial_temp = 1000.0;
     double cooling_rate = 0.95;
     double temperature = initial_temp;
 
-    for (int i = 0; i < max_iters; i++)
+    for (int i = 0; max_iters < 0 || i < max_iters; i++)
     {
-        auto [partial_solution, destroyed] = destroy(current_solution, destruction_rate, instance);
-        Solution new_solution = rebuild(partial_solution, destroyed, instance);
-        evaluator.evaluate(instance, new_solution);
-        int new_cost = evaluator.hard_violations * 1000 + evaluator.total_cost;
-
-        if (new_cost < best_cost)
+        if (stop.should_stop(best_cost))
+            break;
+
+        // Destrói e reconstrói no lugar; o diário permite voltar atrás se o movimento for rejeitado
+        uint64_t previous_hash = current_solution.hash;
+        current_solution.begin_transaction();
+        vector<int> destroyed = destroy(current_solution, current_evaluator, destruction_rate, instance);
+        rebuild(current_solution, destroyed, instance);
+
+        // Reconstrução igual à corrente ou já avaliada: desfaz sem avaliar (o avaliador não foi tocado)
+        uint64_t rebuilt_hash = current_solution.hash;
+        if (rebuilt_hash == previous_hash || visited.contains(rebuilt_hash))
         {
-            best_solution = new_solution;
-            best_cost = new_cost;
-            current_solution = new_solution;
+            current_solution.rollback(instance);
         }
         else
         {
-            double delta = new_cost - best_cost;
-            double acceptance_prob = exp(-delta / temperature);
+            // Só os eventos destruídos (e seus professores) mudaram
+            current_evaluator.rescore(current_solution, destroyed);
 
-            if (dis(gen) < acceptance_prob)
+            // Intensificação; os eventos movidos entram em destroyed para o rescore após um rollback
+            if (use_local_search)
+                local_search.improve(instance, current_solution, current_evaluator, rng, &destroyed);
+            int new_cost = current_evaluator.objective();
+            visited.insert(rebuilt_hash);
+
+            if (new_cost < best_cost)
             {
-                current_solution = new_solution;
+                current_solution.commit();
+                best_solution = current_solution; // cópia completa só ao achar uma nova melhor
+                best_cost = new_cost;
+                stop.improved(best_cost);
+            }
+            else
+            {
+                double delta = new_cost - best_cost;
+                double acceptance_prob = exp(-delta / temperature);
+
+                if (dis(rng) < acceptance_prob)
+                {
+                    current_solution.commit();
+                }
+                else
+                {
+                    current_solution.rollback(instance);
+                    current_evaluator.rescore(current_solution, destroyed);
+                }
             }
         }
 
@@ -269,7 +161,165 @@ Solution IteratedGreedy::solve(Instance &instance, int max_iters, float destruct
         if (i % 50 == 0 && i > 0)
         {
             current_solution = greedy.generate_greedy(instance);
+            current_evaluator.reset(current_solution);
         }
     }
     return best_solution;
 }
+
+namespace
+{
+    // Melhor solução compartilhada entre as threads. O custo fica num atomic à parte: a maioria
+    // das publicações (e das consultas na sincronização) para nele sem tocar no mutex, que só é
+    // tomado para trocar ou copiar o ponteiro da solução.
+    class Incumbent
+    {
+    public:
+        atomic<int> cost{INT_MAX};
+
+        // Publica a solução se ela for melhor que a atual e, ainda sob o mutex, chama on_publish com
+        // o novo custo: as chamadas saem na ordem das trocas, sempre com custo decrescente.
+        // Devolve true se a incumbente foi trocada.
+        template <class Callback>
+        bool publish(const Solution &candidate, int candidate_cost, Callback on_publish)
+        {
+            if (candidate_cost >= cost.load(memory_order_relaxed))
+                return false;
+
+            auto copy = make_shared<const Solution>(candidate);
+            lock_guard<mutex> lock(mtx);
+            if (candidate_cost >= cost.load(memory_order_relaxed))
+                return false;
+            solution = move(copy);
+            cost.store(candidate_cost, memory_order_relaxed);
+            on_publish(candidate_cost);
+            return true;
+        }
+
+        // Solução e custo lidos juntos, sob o mutex
+        shared_ptr<const Solution> get(int &solution_cost)
+        {
+            lock_guard<mutex> lock(mtx);
+            solution_cost = cost.load(memory_order_relaxed);
+            return solution;
+        }
+
+    private:
+        mutex mtx;
+        shared_ptr<const Solution> solution;
+    };
+}
+
+Solution IteratedGreedy::solve_parallel(Instance &instance, int max_iters, float destruction_percentage, int num_threads, int sync_interval,
+                                        StopCriteria stop)
+{
+    stop.start();
+
+    num_threads = max(1, num_threads);
+    sync_interval = max(1, sync_interval);
+
+    int total_events = instance.events.size();
+    int destruction_rate = max(1, static_cast<int>(total_events * destruction_percentage));
+
+    Incumbent incumbent;
+    atomic<int> next_iter(0);
+    atomic<bool> done(false); // prazo ou alvo atingido por alguma cadeia
+
+    auto report = [&](const Solution &solution, int cost)
+    {
+        incumbent.publish(solution, cost, [&](int published_cost)
+                          { stop.improved(published_cost); });
+    };
+
+    auto worker = [&](int t)
+    {
+        IteratedGreedy chain(rng.split(t + 1), greedy.max_restarts); // fluxos próprios da cadeia t
+
+        Solution current_solution = chain.greedy.generate_greedy(instance);
+        IncrementalEvaluator current_evaluator(instance);
+        current_evaluator.reset(current_solution);
+        int current_cost = current_evaluator.objective();
+        report(current_solution, current_cost);
+
+        uniform_real_distribution<> dis(0.0, 1.0);
+
+        double temperature = 1000.0;
+        double cooling_rate = 0.95;
+        int best_cost = current_cost; // melhor custo visto por esta cadeia
+
+        for (int i = 1; !done && (max_iters < 0 || next_iter.fetch_add(1) < max_iters); i++)
+        {
+            if (stop.should_stop(best_cost))
+            {
+                done = true;
+                break;
+            }
+
+            uint64_t previous_hash = current_solution.hash;
+            current_solution.begin_transaction();
+            vector<int> destroyed = chain.destroy(current_solution, current_evaluator, destruction_rate, instance);
+            chain.rebuild(current_solution, destroyed, instance);
+
+            // Mesmo descarte de reconstruções repetidas do solve sequencial
+            uint64_t rebuilt_hash = current_solution.hash;
+            if (rebuilt_hash == previous_hash || chain.visited.contains(rebuilt_hash))
+            {
+                current_solution.rollback(instance);
+            }
+            else
+            {
+                current_evaluator.rescore(current_solution, destroyed);
+                if (use_local_search)
+                    local_search.improve(instance, current_solution, current_evaluator, chain.rng, &destroyed);
+                int new_cost = current_evaluator.objective();
+                chain.visited.insert(rebuilt_hash);
+
+                bool improved = new_cost < best_cost;
+
+                // Mesmo critério de aceitação do solve sequencial
+                if (improved || dis(chain.rng) < exp(-(new_cost - best_cost) / temperature))
+                {
+                    current_solution.commit();
+                    current_cost = new_cost;
+                }
+                else
+                {
+                    current_solution.rollback(instance);
+                    current_evaluator.rescore(current_solution, destroyed);
+                }
+
+                if (improved)
+                {
+                    best_cost = new_cost;
+                    report(current_solution, new_cost);
+                }
+            }
+
+            temperature *= cooling_rate;
+
+            // Sincronização: recomeça da incumbente se outra cadeia achou algo melhor
+            if (i % sync_interval == 0 && incumbent.cost.load(memory_order_relaxed) < current_cost)
+            {
+                int incumbent_cost;
+                shared_ptr<const Solution> best = incumbent.get(incumbent_cost);
+                current_solution = *best;
+                current_evaluator.reset(current_solution);
+                current_cost = incumbent_cost;
+                best_cost = min(best_cost, incumbent_cost);
+            }
+        }
+    };
+
+    vector<thread> threads;
+    for (int t = 0; t < num_threads; t++)
+    {
+        threads.emplace_back(worker, t);
+    }
+    for (thread &t : threads)
+    {
+        t.join();
+    }
+
+    int final_cost;
+    return *incumbent.get(final_cost);
+}
@@ -0,0 +1,279 @@
+#include "../include/LocalSearch.h"
+#include "../include/Greedy.h"
+
+#include <algorithm>
+
+namespace
+{
+    void apply(Solution &solution, IncrementalEvaluator &evaluator, IncrementalEvaluator::Move::Kind kind, const Allocation &alloc)
+    {
+        IncrementalEvaluator::Move move;
+        move.kind = kind;
+        move.alloc = alloc;
+        evaluator.apply(solution, move);
+    }
+
+    // A aula ocupa o horário time (início ou segunda metade de uma aula dupla)
+    bool covers(const Instance &instance, const Allocation &alloc, int time)
+    {
+        if (alloc.time_id == Allocation::UNALLOCATED)
+            return false;
+        return alloc.time_id == time || (alloc.duration == 2 && instance.next_time[alloc.time_id] == time);
+    }
+
+    bool accepts(const Instance &instance, int event_id, int time, int duration)
+    {
+        uint64_t allowed = duration == 2 ? instance.event_double_times[event_id] : instance.event_single_times[event_id];
+        return allowed >> time & 1;
+    }
+
+    // Mantém o diário da solução aberto durante uma passada, para que as tentativas rejeitadas
+    // voltem com rollback_to sem deixar rastro. Se não havia transação, abre e confirma uma.
+    class JournalScope
+    {
+    public:
+        explicit JournalScope(Solution &solution) : solution(solution), opened(!solution.journaling)
+        {
+            if (opened)
+                solution.begin_transaction();
+        }
+
+        ~JournalScope()
+        {
+            if (opened)
+                solution.commit();
+        }
+
+    private:
+        Solution &solution;
+        bool opened;
+    };
+
+    vector<int> shuffled_events(const Instance &instance, RngStream &rng)
+    {
+        vector<int> events(instance.events.size());
+        for (int e = 0; e < (int)events.size(); e++)
+        {
+            events[e] = e;
+        }
+        shuffle(events.begin(), events.end(), rng);
+        return events;
+    }
+}
+
+int LocalSearch::improve(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator, RngStream &rng,
+                         vector<int> *touched) const
+{
+    int total_gain = 0;
+    for (int pass = 0; pass < max_passes; pass++)
+    {
+        int gain = relocate_pass(instance, solution, evaluator, rng, touched);
+        gain += swap_pass(instance, solution, evaluator, rng, touched);
+        gain += kempe_pass(instance, solution, evaluator, rng, touched);
+
+        total_gain += gain;
+        if (gain == 0)
+            break;
+    }
+    return total_gain;
+}
+
+int LocalSearch::relocate_pass(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator, RngStream &rng,
+                               vector<int> *touched) const
+{
+    JournalScope scope(solution);
+
+    int total_gain = 0;
+    for (int event_id : shuffled_events(instance, rng))
+    {
+        const EventInfo &event = instance.events[event_id];
+
+        // Cópia: a lista do evento muda a cada remoção/inserção
+        vector<Allocation> lessons = solution.event_allocations[event_id];
+        for (const Allocation &lesson : lessons)
+        {
+            // Marcadores de aula não alocada só são tentados se couberem numa aula simples ou dupla
+            if (lesson.duration > 2)
+                continue;
+
+            // Com a aula fora, delta_insert dá o custo exato de cada destino sem alterar a solução
+            size_t mark = solution.journal.size();
+            int before = evaluator.objective();
+            apply(solution, evaluator, IncrementalEvaluator::Move::REMOVE, lesson);
+            int removed = evaluator.objective();
+
+            int best_time = -1;
+            int best_delta = before - removed; // reinserir no lugar original
+            uint64_t candidates = Greedy::candidate_times(instance, solution, event, lesson.duration);
+            for (; candidates; candidates &= candidates - 1)
+            {
+                int time_id = __builtin_ctzll(candidates);
+                int delta = evaluator.delta_insert(solution, event_id, time_id, lesson.duration);
+                if (delta < best_delta)
+                {
+                    best_delta = delta;
+                    best_time = time_id;
+                }
+            }
+
+            if (best_time < 0)
+            {
+                solution.rollback_to(instance, mark);
+                evaluator.rescore(solution, {event_id});
+                continue;
+            }
+
+            apply(solution, evaluator, IncrementalEvaluator::Move::INSERT, {event_id, best_time, lesson.duration});
+            total_gain += before - evaluator.objective();
+            if (touched)
+                touched->push_back(event_id);
+        }
+    }
+    return total_gain;
+}
+
+int LocalSearch::swap_pass(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator, RngStream &rng,
+                           vector<int> *touched) const
+{
+    JournalScope scope(solution);
+
+    vector<int> classes(instance.classes.size());
+    for (int c = 0; c < (int)classes.size(); c++)
+    {
+        classes[c] = c;
+    }
+    shuffle(classes.begin(), classes.end(), rng);
+
+    int total_gain = 0;
+    for (int class_id : classes)
+    {
+        vector<Allocation> lessons;
+        for (int event_id : instance.class_events[class_id])
+        {
+            for (const Allocation &alloc : solution.event_allocations[event_id])
+            {
+                if (alloc.time_id != Allocation::UNALLOCATED)
+                    lessons.push_back(alloc);
+            }
+        }
+
+        for (int i = 0; i < (int)lessons.size(); i++)
+        {
+            for (int j = i + 1; j < (int)lessons.size(); j++)
+            {
+                const Allocation &a = lessons[i];
+                const Allocation &b = lessons[j];
+                if (!swappable(instance, a, b))
+                    continue;
+
+                int gain = try_exchange(instance, solution, evaluator, {a, b},
+                                        {{a.event_id, b.time_id, a.duration}, {b.event_id, a.time_id, b.duration}}, touched);
+                if (gain > 0)
+                {
+                    total_gain += gain;
+                    swap(lessons[i].time_id, lessons[j].time_id);
+                }
+            }
+        }
+    }
+    return total_gain;
+}
+
+int LocalSearch::kempe_pass(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator, RngStream &rng,
+                            vector<int> *touched) const
+{
+    int total_gain = 0;
+    if (solution.allocations.empty() || instance.times.size() < 2)
+        return 0;
+
+    JournalScope scope(solution);
+
+    for (int attempt = 0; attempt < kempe_tries; attempt++)
+    {
+        const Allocation start = solution.allocations[uniform_int_distribution<int>(0, solution.allocations.size() - 1)(rng)];
+        if (start.time_id == Allocation::UNALLOCATED || start.duration != 1)
+            continue;
+
+        int other_time = uniform_int_distribution<int>(0, instance.times.size() - 2)(rng);
+        if (other_time >= start.time_id)
+            other_time++;
+
+        vector<Allocation> chain = kempe_chain(instance, solution, start, other_time);
+        // Cadeia de uma aula só é uma realocação
+        if (chain.size() < 2)
+            continue;
+
+        vector<Allocation> swapped = chain;
+        for (Allocation &alloc : swapped)
+        {
+            alloc.time_id = alloc.time_id == start.time_id ? other_time : start.time_id;
+        }
+        total_gain += try_exchange(instance, solution, evaluator, chain, swapped, touched);
+    }
+    return total_gain;
+}
+
+vector<Allocation> LocalSearch::kempe_chain(const Instance &instance, const Solution &solution, const Allocation &start, int other_time)
+{
+    int first_time = start.time_id;
+    vector<Allocation> chain = {start};
+
+    for (size_t k = 0; k < chain.size(); k++)
+    {
+        Allocation current = chain[k];
+        int target = current.time_id == first_time ? other_time : first_time;
+        if (!accepts(instance, current.event_id, target, 1))
+            return {};
+
+        // Aulas no horário de destino que dividem professor ou turma com a aula atual
+        const EventInfo &event = instance.events[current.event_id];
+        for (const vector<int> *group : {&instance.teacher_events[event.teacher_id], &instance.class_events[event.class_id]})
+        {
+            for (int neighbor : *group)
+            {
+                for (const Allocation &alloc : solution.event_allocations[neighbor])
+                {
+                    if (!covers(instance, alloc, target))
+                        continue;
+                    if (alloc.duration != 1)
+                        return {};
+
+                    bool seen = false;
+                    for (const Allocation &member : chain)
+                    {
+                        seen |= member.event_id == alloc.event_id && member.time_id == alloc.time_id;
+                    }
+                    if (!seen)
+                        chain.push_back(alloc);
+                }
+            }
+        }
+    }
+    return chain;
+}
+
+bool LocalSearch::swappable(const Instance &instance, const Allocation &a, const Allocation &b)
+{
+    if (a.event_id == b.event_id || a.duration != b.duration || a.time_id == b.time_id ||
+        a.time_id == Allocation::UNALLOCATED || b.time_id == Allocation::UNALLOCATED)
+        return false;
+    return accepts(instance, a.event_id, b.time_id, a.duration) && accepts(instance, b.event_id, a.time_id, b.duration);
+}
+
+int LocalSearch::try_exchange(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator,
+                              const vector<Allocation> &from, const vector<Allocation> &to, vector<int> *touched)
+{
+    int delta;
+    if (!exchange(instance, solution, evaluator, from, to, [](int d)
+                  { return d < 0; }, delta))
+        return 0;
+
+    if (touched)
+    {
+        for (const Allocation &alloc : to)
+        {
+            touched->push_back(alloc.event_id);
+        }
+    }
+    return -delta;
+}
@@ -1,145 +1,183 @@
 #include "../include/Instance.h"
 #include "../include/IteratedGreedy.h"
 #include "../include/BeeColony.h"
-#include "../include/tinyxml2.h"
+#include "../include/XmlReader.h"
+#include "../include/SolutionWriter.h"
+#include "../include/Batch.h"
+#include "../include/SelfCheck.h"
 
 #include <iostream>
+#include <fstream>
+#include <unistd.h>
 
-using namespace tinyxml2;
 using namespace std;
 
 vector<Solution> load_solutions_from_xml(const string &filename, const Instance &instance)
 {
-    XMLDocument doc;
     vector<Solution> solutions;
 
-    if (doc.LoadFile(filename.c_str()) != XML_SUCCESS)
+    ifstream file(filename);
+    if (!file)
     {
         cerr << "Erro ao carregar o arquivo XML: " << filename << endl;
         return solutions;
     }
 
-    XMLElement *root = doc.FirstChildElement("HighSchoolTimetableArchive");
-    if (!root)
-        return solutions;
+    // Leitura em fluxo: cada Solution é montada direto, sem guardar o documento
+    XmlReader reader(file);
+
+    // Avança até o filho chamado name, ignorando os demais; false se o pai acabar antes
+    auto find_child = [&](const char *name)
+    {
+        while (reader.next_child())
+        {
+            if (reader.name() == name)
+                return true;
+            reader.skip();
+        }
+        return false;
+    };
 
-    XMLElement *solution_groups = root->FirstChildElement("SolutionGroups");
-    if (!solution_groups)
+    if (!find_child("HighSchoolTimetableArchive") || !find_child("SolutionGroups"))
         return solutions;
 
-    for (XMLElement *group = solution_groups->FirstChildElement("SolutionGroup");
-         group;
-         group = group->NextSiblingElement("SolutionGroup"))
+    while (find_child("SolutionGroup"))
     {
-        for (XMLElement *solution_elem = group->FirstChildElement("Solution");
-             solution_elem;
-             solution_elem = solution_elem->NextSiblingElement("Solution"))
+        while (find_child("Solution"))
         {
+            Solution solution(instance);
+            bool has_events = false;
 
-            Solution solution;
-            XMLElement *events_elem = solution_elem->FirstChildElement("Events");
-            if (!events_elem)
-                continue;
-
-            for (XMLElement *event_elem = events_elem->FirstChildElement("Event");
-                 event_elem;
-                 event_elem = event_elem->NextSiblingElement("Event"))
+            while (reader.next_child())
             {
-
-                Allocation alloc;
-                alloc.event_id = event_elem->Attribute("Reference");
-
-                XMLElement *duration_elem = event_elem->FirstChildElement("Duration");
-                if (duration_elem && duration_elem->GetText())
-                {
-                    alloc.duration = atoi(duration_elem->GetText());
-                }
-
-                XMLElement *time_elem = event_elem->FirstChildElement("Time");
-                if (time_elem && time_elem->Attribute("Reference"))
+                if (reader.name() != "Events")
                 {
-                    alloc.time_id = time_elem->Attribute("Reference");
+                    reader.skip();
+                    continue;
                 }
+                has_events = true;
 
-                solution.allocations.push_back(alloc);
-                solution.event_allocations[alloc.event_id].push_back(alloc);
-                solution.allocated_duration[alloc.event_id] += alloc.duration;
-
-                if (instance.event_index.find(alloc.event_id) != instance.event_index.end())
+                while (find_child("Event"))
                 {
-                    const EventInfo &event = instance.events.at(instance.event_index.at(alloc.event_id));
-                    const TimeInfo &t = instance.times.at(instance.time_index.at(alloc.time_id));
+                    const char *event_ref = reader.attribute("Reference");
+                    auto event_it = event_ref ? instance.event_index.find(event_ref) : instance.event_index.end();
 
-                    solution.event_day_counts[alloc.event_id][t.day]++;
-                    solution.teacher_schedule[event.teacher_id].insert(t.day);
+                    Allocation alloc;
+                    alloc.event_id = event_it != instance.event_index.end() ? event_it->second : -1;
+                    alloc.time_id = Allocation::UNALLOCATED;
+                    alloc.duration = 0;
 
-                    if (alloc.duration == 2)
+                    while (reader.next_child())
                     {
-                        solution.event_double_lessons[alloc.event_id]++;
+                        if (reader.name() == "Duration")
+                        {
+                            alloc.duration = atoi(reader.read_text().c_str());
+                        }
+                        else if (reader.name() == "Time")
+                        {
+                            const char *time_ref = reader.attribute("Reference");
+                            if (time_ref && instance.time_index.find(time_ref) != instance.time_index.end())
+                            {
+                                alloc.time_id = instance.time_index.at(time_ref);
+                            }
+                            reader.skip();
+                        }
+                        else
+                        {
+                            reader.skip();
+                        }
                     }
+
+                    if (alloc.event_id < 0)
+                        continue;
+
+                    solution.add_allocation(instance, alloc);
                 }
             }
-            solutions.push_back(solution);
+
+            if (has_events)
+                solutions.push_back(solution);
         }
     }
+
+    if (reader.failed())
+    {
+        cerr << "Erro ao carregar o arquivo XML: " << filename << endl;
+    }
     return solutions;
 }
 
-#include <vector>
-#include <string>
-#include <ctime>
-#include <iomanip>
-#include <sstream>
+// Modo lote: tf --batch <configurações> <threads> <diretório de saída> <instância>...
+int run_batch(int argc, char **argv)
+{
+    if (argc < 6)
+    {
+        cerr << "Uso: " << argv[0] << " --batch <configurações> <threads> <diretório de saída> <instância>..." << endl;
+        return 1;
+    }
+
+    vector<BatchConfig> configs = BatchConfig::parse_file(argv[2]);
+    int num_threads = atoi(argv[3]);
+    string output_dir = argv[4];
+    vector<string> instance_paths(argv + 5, argv + argc);
+
+    if (configs.empty())
+    {
+        cerr << "Nenhuma configuração em " << argv[2] << endl;
+        return 1;
+    }
+
+    // Instância que não carregou ou erro de gravação: os outros jobs rodam, mas a saída indica a falha
+    vector<BatchResult> results = Batch::run(instance_paths, configs, num_threads, output_dir);
+    for (const BatchResult &result : results)
+    {
+        if (result.failed)
+            return 1;
+    }
+    return 0;
+}
 
-std::string solutionToXML(
-    const std::vector<Allocation> &allocations,
-    const std::string &instanceId = "BrazilInstance1_XHSTT-v2014")
+// Verificação de consistência: tf --selfcheck [instância...] (sem argumentos, as instâncias em instances/)
+int run_selfcheck(int argc, char **argv)
 {
-    // Gerar data atual no formato "December 2011"
-    auto t = std::time(nullptr);
-    auto tm = *std::localtime(&t);
-    std::ostringstream dateStream;
-    dateStream << std::put_time(&tm, "%B %Y");
-    std::string currentDate = dateStream.str();
-
-    // Início do documento XML
-    std::string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
-    xml += "<HighSchoolTimetableArchive>\n";
-    xml += "  <SolutionGroups>\n";
-    xml += "    <SolutionGroup Id=\"GeneratedSolution\">\n";
-    xml += "      <MetaData>\n";
-    xml += "        <Contributor>Automated Solution Generator</Contributor>\n";
-    xml += "        <Date>" + currentDate + "</Date>\n";
-    xml += "        <Description>Solution generated programmatically</Description>\n";
-    xml += "      </MetaData>\n";
-    xml += "      <Solution Reference=\"" + instanceId + "\">\n";
-    xml += "        <Events>\n";
-
-    // Adicionar cada alocação como evento
-    for (const auto &alloc : allocations)
+    vector<string> instance_paths(argv + 2, argv + argc);
+    if (instance_paths.empty())
     {
-        xml += "          <Event Reference=\"" + alloc.event_id + "\">\n";
-        xml += "            <Duration>" + std::to_string(alloc.duration) + "</Duration>\n";
-        xml += "            <Time Reference=\"" + alloc.time_id + "\"/>\n";
-        xml += "          </Event>\n";
+        for (int i = 1; i <= 7; i++)
+            instance_paths.push_back("instances/instance" + to_string(i) + ".xml");
     }
 
-    // Fechar tags do XML
-    xml += "        </Events>\n";
-    xml += "      </Solution>\n";
-    xml += "    </SolutionGroup>\n";
-    xml += "  </SolutionGroups>\n";
-    xml += "</HighSchoolTimetableArchive>";
+    int failures = 0;
+    for (const string &path : instance_paths)
+    {
+        Instance instance;
+        if (!instance.load(path, false))
+        {
+            failures++;
+            continue;
+        }
 
-    return xml;
+        SelfCheck check;
+        bool ok = check.run(instance, path);
+        cout << path << ": " << (ok ? "ok" : "FALHOU") << endl;
+        if (!ok)
+            failures++;
+    }
+    return failures == 0 ? 0 : 1;
 }
 
-int main()
+int main(int argc, char **argv)
 {
+    if (argc > 1 && string(argv[1]) == "--batch")
+        return run_batch(argc, argv);
+    if (argc > 1 && string(argv[1]) == "--selfcheck")
+        return run_selfcheck(argc, argv);
+
     string path = "instances/instance1.xml";
 
     Instance instance;
-    instance.load(path);
+    if (!instance.load(path))
+        return 1;
 
     Evaluator evaluator;
 
@@ -184,8 +222,11 @@ int main()
     // evaluator.evaluate(instance, bee_colony_solution);
     // evaluator.print_report();
 
-    std::string xmlSolution = solutionToXML(iterated_greedy_solution.allocations);
-    std::cout << xmlSolution << std::endl;
+    cout.flush();
+    SolutionWriter writer(STDOUT_FILENO);
+    writer.begin();
+    writer.write(instance, iterated_greedy_solution);
+    writer.finish();
 
     return 0;
 }
\ No newline at end of file
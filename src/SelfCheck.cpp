@@ -0,0 +1,269 @@
+#include "../include/SelfCheck.h"
+#include "../include/Greedy.h"
+#include "../include/Evaluator.h"
+
+#include <iostream>
+#include <algorithm>
+
+bool SelfCheck::matches_evaluator(const Instance &instance, const Solution &solution, const IncrementalEvaluator &evaluator,
+                                  const string &where)
+{
+    Evaluator full;
+    full.evaluate(instance, solution);
+
+    // O Evaluator conta HARD_WEIGHT por violação hard; o incremental só pesa as soft
+    for (int type = 0; type < ConstraintInfo::UNKNOWN; type++)
+    {
+        bool hard = Evaluator::is_hard((ConstraintInfo::Type)type);
+        if (full.type_violations[type] != evaluator.violations[type] || (!hard && full.type_costs[type] != evaluator.costs[type]))
+        {
+            cerr << where << ": " << ConstraintInfo::type_name((ConstraintInfo::Type)type) << " incremental "
+                 << evaluator.violations[type] << " (custo " << evaluator.costs[type] << "), Evaluator "
+                 << full.type_violations[type] << " (custo " << full.type_costs[type] << ")" << endl;
+            return false;
+        }
+    }
+
+    if (full.hard_violations != evaluator.hard_violations() || full.soft_violations != evaluator.soft_violations() ||
+        full.total_cost != evaluator.total_cost())
+    {
+        cerr << where << ": totais incrementais " << evaluator.hard_violations() << "/" << evaluator.soft_violations() << "/"
+             << evaluator.total_cost() << ", Evaluator " << full.hard_violations << "/" << full.soft_violations << "/"
+             << full.total_cost << endl;
+        return false;
+    }
+    return true;
+}
+
+bool SelfCheck::random_move(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator, const string &where)
+{
+    IncrementalEvaluator::Move move;
+
+    // Remove com mais frequência quando a solução passa da duração total, para o passeio não crescer
+    bool insert = solution.allocations.empty() ||
+                  rng.uniform() < ((int)solution.allocations.size() > total_duration ? 0.3 : 0.5);
+
+    int predicted;
+    if (insert)
+    {
+        move.kind = IncrementalEvaluator::Move::INSERT;
+        move.alloc.event_id = uniform_int_distribution<int>(0, instance.events.size() - 1)(rng);
+        move.alloc.time_id = uniform_int_distribution<int>(0, instance.times.size() - 1)(rng);
+        move.alloc.duration = (instance.double_starts >> move.alloc.time_id & 1) && rng.uniform() < 0.3 ? 2 : 1;
+        predicted = evaluator.delta_insert(solution, move.alloc.event_id, move.alloc.time_id, move.alloc.duration);
+    }
+    else
+    {
+        move.kind = IncrementalEvaluator::Move::REMOVE;
+        move.alloc = solution.allocations[uniform_int_distribution<int>(0, solution.allocations.size() - 1)(rng)];
+        predicted = evaluator.delta_remove(solution, move.alloc.event_id, move.alloc.time_id, move.alloc.duration);
+    }
+
+    int before = evaluator.objective();
+    evaluator.apply(solution, move);
+    int actual = evaluator.objective() - before;
+    if (predicted != actual)
+    {
+        cerr << where << ": " << (insert ? "inserção" : "remoção") << " do evento " << instance.events[move.alloc.event_id].id
+             << " no horário " << move.alloc.time_id << " (duração " << move.alloc.duration << "): delta previsto "
+             << predicted << ", real " << actual << endl;
+        return false;
+    }
+    return true;
+}
+
+vector<Allocation> SelfCheck::sorted_lessons(const vector<Allocation> &allocations)
+{
+    vector<Allocation> lessons = allocations;
+    sort(lessons.begin(), lessons.end(), [](const Allocation &a, const Allocation &b)
+         {
+             if (a.event_id != b.event_id)
+                 return a.event_id < b.event_id;
+             if (a.time_id != b.time_id)
+                 return a.time_id < b.time_id;
+             return a.duration < b.duration;
+         });
+    return lessons;
+}
+
+bool SelfCheck::matches_rebuild(const Instance &instance, const Solution &solution, const vector<Allocation> &lessons,
+                                uint64_t hash, const string &where)
+{
+    auto fail = [&](const char *what)
+    {
+        cerr << where << ": " << what << " diverge" << endl;
+        return false;
+    };
+    auto same = [](const Allocation &a, const Allocation &b)
+    {
+        return a.event_id == b.event_id && a.time_id == b.time_id && a.duration == b.duration;
+    };
+
+    vector<Allocation> current = sorted_lessons(solution.allocations);
+    if (current.size() != lessons.size() || !equal(current.begin(), current.end(), lessons.begin(), same))
+        return fail("aulas (em relação ao retrato)");
+    if (solution.hash != hash)
+        return fail("hash (em relação ao retrato)");
+
+    // Índices por evento apontam para a própria aula em allocations
+    for (int e = 0; e < (int)instance.events.size(); e++)
+    {
+        if (solution.event_allocation_index[e].size() != solution.event_allocations[e].size())
+            return fail("event_allocation_index");
+        for (size_t k = 0; k < solution.event_allocations[e].size(); k++)
+        {
+            int position = solution.event_allocation_index[e][k];
+            if (position < 0 || position >= (int)solution.allocations.size() ||
+                !same(solution.allocations[position], solution.event_allocations[e][k]))
+                return fail("event_allocation_index");
+        }
+    }
+
+    Solution rebuilt(instance);
+    for (const Allocation &alloc : solution.allocations)
+        rebuilt.add_allocation(instance, alloc);
+
+    for (int e = 0; e < (int)instance.events.size(); e++)
+    {
+        vector<Allocation> mine = sorted_lessons(solution.event_allocations[e]);
+        vector<Allocation> theirs = sorted_lessons(rebuilt.event_allocations[e]);
+        if (mine.size() != theirs.size() || !equal(mine.begin(), mine.end(), theirs.begin(), same))
+            return fail("event_allocations");
+    }
+
+    if (solution.hash != rebuilt.hash)
+        return fail("hash");
+    if (solution.teacher_schedule != rebuilt.teacher_schedule || solution.class_schedule != rebuilt.class_schedule)
+        return fail("agenda de professores/turmas");
+    if (solution.teacher_day_lessons != rebuilt.teacher_day_lessons || solution.class_day_lessons != rebuilt.class_day_lessons)
+        return fail("aulas por dia");
+    if (solution.event_day_counts != rebuilt.event_day_counts || solution.event_double_lessons != rebuilt.event_double_lessons ||
+        solution.allocated_duration != rebuilt.allocated_duration)
+        return fail("contagens por evento");
+    if (solution.teacher_day_slots != rebuilt.teacher_day_slots || solution.teacher_time_starts != rebuilt.teacher_time_starts)
+        return fail("slots dos professores");
+
+    const Occupancy &a = solution.occupancy;
+    const Occupancy &b = rebuilt.occupancy;
+    if (a.teacher_busy != b.teacher_busy || a.class_busy != b.class_busy || a.teacher_load != b.teacher_load ||
+        a.class_load != b.class_load || a.clashes != b.clashes)
+        return fail("ocupação");
+    return true;
+}
+
+bool SelfCheck::random_transaction(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator,
+                                   const string &where)
+{
+    vector<Allocation> before_lessons = sorted_lessons(solution.allocations);
+    uint64_t before_hash = solution.hash;
+    int before_objective = evaluator.objective();
+
+    solution.begin_transaction();
+    int first = uniform_int_distribution<int>(0, transaction_moves)(rng);
+    for (int i = 0; i < first; i++)
+    {
+        if (!random_move(instance, solution, evaluator, where))
+            return false;
+    }
+
+    size_t mark = solution.journal.size();
+    vector<Allocation> mark_lessons = sorted_lessons(solution.allocations);
+    uint64_t mark_hash = solution.hash;
+    int mark_objective = evaluator.objective();
+
+    int second = uniform_int_distribution<int>(1, transaction_moves)(rng);
+    for (int i = 0; i < second; i++)
+    {
+        if (!random_move(instance, solution, evaluator, where))
+            return false;
+    }
+
+    // Eventos tocados depois de uma posição do diário, para o avaliador acompanhar o rollback
+    auto touched_after = [&](size_t position)
+    {
+        vector<int> events;
+        for (size_t i = position; i < solution.journal.size(); i++)
+            events.push_back(solution.journal[i].alloc.event_id);
+        sort(events.begin(), events.end());
+        events.erase(unique(events.begin(), events.end()), events.end());
+        return events;
+    };
+
+    vector<int> events = touched_after(mark);
+    solution.rollback_to(instance, mark);
+    evaluator.rescore(solution, events);
+    if (!solution.journaling || solution.journal.size() != mark)
+    {
+        cerr << where << ": rollback_to não manteve a transação aberta na marca" << endl;
+        return false;
+    }
+    if (!matches_rebuild(instance, solution, mark_lessons, mark_hash, where + " (rollback_to)"))
+        return false;
+    if (evaluator.objective() != mark_objective)
+    {
+        cerr << where << ": objetivo após rollback_to " << evaluator.objective() << ", esperado " << mark_objective << endl;
+        return false;
+    }
+
+    // Metade das transações é desfeita por inteiro; as outras são confirmadas
+    if (rng.uniform() < 0.5)
+    {
+        events = touched_after(0);
+        solution.rollback(instance);
+        evaluator.rescore(solution, events);
+        if (!matches_rebuild(instance, solution, before_lessons, before_hash, where + " (rollback)"))
+            return false;
+        if (evaluator.objective() != before_objective)
+        {
+            cerr << where << ": objetivo após rollback " << evaluator.objective() << ", esperado " << before_objective << endl;
+            return false;
+        }
+    }
+    else
+        solution.commit();
+
+    if (solution.journaling || !solution.journal.empty())
+    {
+        cerr << where << ": diário aberto após fechar a transação" << endl;
+        return false;
+    }
+    return matches_evaluator(instance, solution, evaluator, where);
+}
+
+bool SelfCheck::run(const Instance &instance, const string &name)
+{
+    if (instance.events.empty() || instance.times.empty())
+        return true;
+
+    total_duration = 0;
+    for (const EventInfo &event : instance.events)
+        total_duration += event.total_duration;
+
+    Greedy greedy(Greedy::DEFAULT_MAX_RESTARTS, rng.split(0));
+    Solution solution = greedy.generate_greedy(instance);
+    IncrementalEvaluator evaluator(instance);
+    evaluator.reset(solution);
+    if (!matches_evaluator(instance, solution, evaluator, name + ": solução inicial"))
+        return false;
+
+    for (int move = 1; move <= moves; move++)
+    {
+        string where = name + ": movimento " + to_string(move);
+        if (!random_move(instance, solution, evaluator, where))
+            return false;
+        if (move % transaction_interval == 0 && !random_transaction(instance, solution, evaluator, where))
+            return false;
+        if ((move % full_interval == 0 || move == moves) && !matches_evaluator(instance, solution, evaluator, where))
+            return false;
+    }
+
+    // Uma avaliação incremental do zero tem de dar o mesmo estado que a mantida pelos movimentos
+    IncrementalEvaluator fresh(instance);
+    fresh.reset(solution);
+    if (fresh.objective() != evaluator.objective())
+    {
+        cerr << name << ": objetivo mantido " << evaluator.objective() << ", recalculado " << fresh.objective() << endl;
+        return false;
+    }
+    return true;
+}
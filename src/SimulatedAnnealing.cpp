@@ -0,0 +1,205 @@
+#include "../include/SimulatedAnnealing.h"
+#include "../include/LocalSearch.h"
+#include "../include/CompactSolution.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+void SimulatedAnnealing::seed(uint64_t value)
+{
+    rng = RngStream(value);
+    greedy.rng = rng.split(0);
+}
+
+template <class Accept>
+int SimulatedAnnealing::try_relocate(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator, Accept accept)
+{
+    Allocation lesson = solution.allocations[uniform_int_distribution<int>(0, solution.allocations.size() - 1)(rng)];
+    if (lesson.duration > 2)
+        return INT_MAX;
+
+    uint64_t targets = lesson.duration == 2 ? instance.event_double_times[lesson.event_id] : instance.event_single_times[lesson.event_id];
+    if (lesson.time_id != Allocation::UNALLOCATED)
+        targets &= ~(1ULL << lesson.time_id);
+    if (targets == 0)
+        return INT_MAX;
+
+    Allocation target = {lesson.event_id, rng.pick_bit(targets), lesson.duration};
+
+    // Com a aula fora, delta_insert dá o custo exato do destino
+    int before = evaluator.objective();
+    evaluator.apply(solution, {IncrementalEvaluator::Move::REMOVE, lesson});
+    int delta = evaluator.objective() - before + evaluator.delta_insert(solution, target.event_id, target.time_id, target.duration);
+
+    if (accept(delta))
+    {
+        evaluator.apply(solution, {IncrementalEvaluator::Move::INSERT, target});
+        return delta;
+    }
+    evaluator.apply(solution, {IncrementalEvaluator::Move::INSERT, lesson});
+    return INT_MAX;
+}
+
+template <class Accept>
+int SimulatedAnnealing::try_swap(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator, Accept accept)
+{
+    Allocation a = solution.allocations[uniform_int_distribution<int>(0, solution.allocations.size() - 1)(rng)];
+    const vector<int> &class_events = instance.class_events[instance.events[a.event_id].class_id];
+    const vector<Allocation> &other_lessons = solution.event_allocations[class_events[uniform_int_distribution<int>(0, class_events.size() - 1)(rng)]];
+    if (other_lessons.empty())
+        return INT_MAX;
+    Allocation b = other_lessons[uniform_int_distribution<int>(0, other_lessons.size() - 1)(rng)];
+
+    if (!LocalSearch::swappable(instance, a, b))
+        return INT_MAX;
+
+    int delta;
+    if (LocalSearch::exchange(instance, solution, evaluator, {a, b}, {{a.event_id, b.time_id, a.duration}, {b.event_id, a.time_id, b.duration}},
+                              accept, delta))
+        return delta;
+    return INT_MAX;
+}
+
+template <class Accept>
+int SimulatedAnnealing::try_move(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator, Accept accept)
+{
+    if (rng.uniform() < swap_probability)
+        return try_swap(instance, solution, evaluator, accept);
+    return try_relocate(instance, solution, evaluator, accept);
+}
+
+double SimulatedAnnealing::calibrate(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator)
+{
+    // Só avalia: todo movimento é rejeitado e a solução volta ao estado original
+    double worse_sum = 0;
+    int worse_count = 0;
+    for (int k = 0; k < calibration_samples; k++)
+    {
+        try_move(instance, solution, evaluator, [&](int delta)
+                 {
+                     if (delta > 0 && delta < IncrementalEvaluator::HARD_WEIGHT)
+                     {
+                         worse_sum += delta;
+                         worse_count++;
+                     }
+                     return false;
+                 });
+    }
+
+    double mean_worse = worse_count ? worse_sum / worse_count : 1.0;
+    return max(1e-3, -mean_worse / log(initial_acceptance));
+}
+
+Solution SimulatedAnnealing::solve(Instance &instance, long long max_moves, StopCriteria stop)
+{
+    stop.start();
+
+    Solution current_solution = greedy.generate_greedy(instance);
+    IncrementalEvaluator evaluator(instance);
+    evaluator.reset(current_solution);
+
+    int current_cost = evaluator.objective();
+    int best_cost = current_cost;
+    stop.improved(best_cost);
+
+    // A melhor solução fica como CompactSolution (uma cópia plana das aulas a cada melhora) e só
+    // é remontada no reaquecimento e no fim; se a instância não couber, guarda a Solution inteira
+    bool compact = CompactSolution::fits(instance);
+    CompactSolution best_compact;
+    Solution best_solution;
+    auto save_best = [&]()
+    {
+        if (!compact || !best_compact.assign(instance, current_solution))
+        {
+            compact = false;
+            best_solution = current_solution;
+        }
+    };
+    auto load_best = [&]()
+    {
+        return compact ? best_compact.expand(instance) : best_solution;
+    };
+    save_best();
+
+    total_moves = 0;
+    total_accepted = 0;
+    total_reheats = 0;
+    if (current_solution.allocations.empty())
+        return current_solution;
+
+    double initial_temp = calibrate(instance, current_solution, evaluator);
+    double temperature = initial_temp;
+
+    // Cada segmento de resfriamento vai de segment_temp (no progresso segment_start) até
+    // final_ratio * initial_temp no fim do prazo; reaquecer abre um novo segmento
+    double segment_temp = initial_temp;
+    double segment_start = 0;
+    long long last_improvement = 0;
+
+    auto progress = [&]()
+    {
+        if (stop.time_limit > 0)
+            return stop.elapsed() / stop.time_limit;
+        if (max_moves > 0)
+            return (double)total_moves / max_moves;
+        return -1.0;
+    };
+
+    bool scheduled = stop.time_limit > 0 || max_moves > 0;
+
+    auto accept = [&](int delta)
+    {
+        return delta <= 0 || rng.uniform() < exp(-delta / temperature);
+    };
+
+    const int CHECK_INTERVAL = 1024; // movimentos entre consultas ao relógio
+
+    for (; max_moves < 0 || total_moves < max_moves; total_moves++)
+    {
+        if (total_moves % CHECK_INTERVAL == 0)
+        {
+            if (stop.should_stop(best_cost))
+                break;
+
+            double p = progress();
+            if (p >= 0)
+            {
+                double span = max(1e-9, 1.0 - segment_start);
+                double t = min(1.0, (p - segment_start) / span);
+                temperature = segment_temp * pow(initial_temp * final_ratio / segment_temp, t);
+            }
+
+            if (total_moves - last_improvement >= reheat_after)
+            {
+                // Estagnou: volta para a melhor solução e reaquece
+                current_solution = load_best();
+                evaluator.reset(current_solution);
+                current_cost = best_cost;
+                segment_temp = temperature = max(temperature, reheat_ratio * initial_temp);
+                segment_start = max(0.0, p);
+                last_improvement = total_moves;
+                total_reheats++;
+            }
+        }
+
+        if (!scheduled)
+            temperature = max(temperature * cooling_rate, initial_temp * final_ratio);
+
+        int delta = try_move(instance, current_solution, evaluator, accept);
+        if (delta == INT_MAX)
+            continue;
+
+        total_accepted++;
+        current_cost += delta;
+        if (current_cost < best_cost)
+        {
+            save_best();
+            best_cost = current_cost;
+            last_improvement = total_moves;
+            stop.improved(best_cost);
+        }
+    }
+
+    return load_best();
+}
@@ -0,0 +1,167 @@
+#include "../include/Solution.h"
+
+#include <algorithm>
+
+void Solution::add_allocation(const Instance &instance, Allocation alloc)
+{
+    const EventInfo &event = instance.events[alloc.event_id];
+
+    event_allocations[alloc.event_id].push_back(alloc);
+    event_allocation_index[alloc.event_id].push_back(allocations.size());
+    allocations.push_back(alloc);
+    hash += allocation_key(alloc);
+
+    if (journaling)
+    {
+        journal.push_back({true, alloc});
+    }
+
+    // Aulas não alocadas ficam registradas, mas não contam como duração alocada
+    if (alloc.time_id == Allocation::UNALLOCATED)
+        return;
+
+    allocated_duration[alloc.event_id] += alloc.duration;
+
+    const TimeInfo &t = instance.times[alloc.time_id];
+
+    event_day_counts[alloc.event_id][t.day]++;
+    if (teacher_time_starts[event.teacher_id][t.index]++ == 0)
+    {
+        teacher_day_slots[event.teacher_id][t.day] |= 1ULL << t.slot;
+    }
+    if (teacher_day_lessons[event.teacher_id][t.day]++ == 0)
+    {
+        teacher_schedule[event.teacher_id].insert(t.day);
+    }
+    if (class_day_lessons[event.class_id][t.day]++ == 0)
+    {
+        class_schedule[event.class_id].insert(t.day);
+    }
+    occupancy.add(event.teacher_id, event.class_id, t.index);
+
+    if (alloc.duration == 2)
+    {
+        event_double_lessons[alloc.event_id]++;
+
+        int next_id = instance.next_time[t.index];
+        if (next_id >= 0)
+        {
+            occupancy.add(event.teacher_id, event.class_id, next_id);
+        }
+    }
+}
+
+bool Solution::remove_allocation(const Instance &instance, Allocation alloc)
+{
+    auto same = [&](const Allocation &a)
+    {
+        return a.event_id == alloc.event_id && a.time_id == alloc.time_id && a.duration == alloc.duration;
+    };
+
+    vector<Allocation> &event_allocs = event_allocations[alloc.event_id];
+    vector<int> &event_index = event_allocation_index[alloc.event_id];
+    auto event_it = find_if(event_allocs.begin(), event_allocs.end(), same);
+    if (event_it == event_allocs.end())
+        return false;
+
+    // Troca com a última aula do evento e remove do fim
+    int k = event_it - event_allocs.begin();
+    int position = event_index[k];
+    event_allocs[k] = event_allocs.back();
+    event_index[k] = event_index.back();
+    event_allocs.pop_back();
+    event_index.pop_back();
+
+    // Mesmo esquema em allocations; a aula movida tem sua posição corrigida
+    int last = allocations.size() - 1;
+    if (position != last)
+    {
+        const Allocation &moved = allocations[last];
+        vector<int> &moved_index = event_allocation_index[moved.event_id];
+        *find(moved_index.begin(), moved_index.end(), last) = position;
+        allocations[position] = moved;
+    }
+    allocations.pop_back();
+    hash -= allocation_key(alloc);
+
+    if (journaling)
+    {
+        journal.push_back({false, alloc});
+    }
+
+    if (alloc.time_id == Allocation::UNALLOCATED)
+        return true;
+
+    allocated_duration[alloc.event_id] -= alloc.duration;
+
+    const EventInfo &event = instance.events[alloc.event_id];
+    const TimeInfo &t = instance.times[alloc.time_id];
+
+    event_day_counts[alloc.event_id][t.day]--;
+    if (--teacher_time_starts[event.teacher_id][t.index] == 0)
+    {
+        teacher_day_slots[event.teacher_id][t.day] &= ~(1ULL << t.slot);
+    }
+    occupancy.remove(event.teacher_id, event.class_id, t.index);
+
+    if (alloc.duration == 2)
+    {
+        event_double_lessons[alloc.event_id]--;
+
+        int next_id = instance.next_time[t.index];
+        if (next_id >= 0)
+        {
+            occupancy.remove(event.teacher_id, event.class_id, next_id);
+        }
+    }
+
+    // O dia só sai da agenda quando o professor/turma fica sem aulas nele
+    if (--teacher_day_lessons[event.teacher_id][t.day] == 0)
+    {
+        teacher_schedule[event.teacher_id].erase(t.day);
+    }
+    if (--class_day_lessons[event.class_id][t.day] == 0)
+    {
+        class_schedule[event.class_id].erase(t.day);
+    }
+
+    return true;
+}
+
+void Solution::begin_transaction()
+{
+    journal.clear();
+    journaling = true;
+}
+
+void Solution::commit()
+{
+    journal.clear();
+    journaling = false;
+}
+
+void Solution::rollback(const Instance &instance)
+{
+    rollback_to(instance, 0);
+    commit();
+}
+
+void Solution::rollback_to(const Instance &instance, size_t mark)
+{
+    // As operações inversas não são registradas
+    bool was_journaling = journaling;
+    journaling = false;
+
+    while (journal.size() > mark)
+    {
+        Change change = journal.back();
+        journal.pop_back();
+
+        if (change.added)
+            remove_allocation(instance, change.alloc);
+        else
+            add_allocation(instance, change.alloc);
+    }
+
+    journaling = was_journaling;
+}
@@ -0,0 +1,202 @@
+#include "../include/SolutionWriter.h"
+
+#include <cstring>
+#include <ctime>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+SolutionWriter::SolutionWriter(int fd, size_t buffer_size) : buffer(buffer_size), fd(fd) {}
+
+SolutionWriter::SolutionWriter(const string &path, size_t buffer_size)
+    : buffer(buffer_size), fd(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)), owns_fd(true)
+{
+    has_error = fd < 0;
+}
+
+SolutionWriter::~SolutionWriter()
+{
+    if (in_group)
+        finish();
+    else
+        flush();
+
+    if (owns_fd && fd >= 0)
+        close(fd);
+}
+
+void SolutionWriter::flush()
+{
+    size_t done = 0;
+    while (done < used && !has_error)
+    {
+        ssize_t n = ::write(fd, buffer.data() + done, used - done);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            has_error = true;
+            break;
+        }
+        done += n;
+    }
+    used = 0;
+}
+
+void SolutionWriter::put(const char *data, size_t size)
+{
+    if (size > buffer.size() - used)
+    {
+        flush();
+
+        // Maior que o buffer inteiro: vai direto para o descritor
+        if (size > buffer.size())
+        {
+            while (size > 0 && !has_error)
+            {
+                ssize_t n = ::write(fd, data, size);
+                if (n < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    has_error = true;
+                    break;
+                }
+                data += n;
+                size -= n;
+            }
+            return;
+        }
+    }
+
+    memcpy(buffer.data() + used, data, size);
+    used += size;
+}
+
+void SolutionWriter::put(const char *text)
+{
+    put(text, strlen(text));
+}
+
+void SolutionWriter::put_int(int value)
+{
+    char digits[12];
+    int n = 0;
+    unsigned int magnitude = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+    do
+    {
+        digits[n++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0)
+        digits[n++] = '-';
+
+    char out[12];
+    for (int i = 0; i < n; i++)
+    {
+        out[i] = digits[n - 1 - i];
+    }
+    put(out, n);
+}
+
+void SolutionWriter::put_escaped(const string &text)
+{
+    // Copia trechos sem caracteres especiais de uma vez
+    size_t start = 0;
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        const char *entity = nullptr;
+        switch (text[i])
+        {
+        case '&':
+            entity = "&amp;";
+            break;
+        case '<':
+            entity = "&lt;";
+            break;
+        case '>':
+            entity = "&gt;";
+            break;
+        case '"':
+            entity = "&quot;";
+            break;
+        default:
+            continue;
+        }
+        put(text.data() + start, i - start);
+        put(entity);
+        start = i + 1;
+    }
+    put(text.data() + start, text.size() - start);
+}
+
+void SolutionWriter::begin(const string &group_id)
+{
+    // Data atual no formato "December 2011"
+    char date[64];
+    time_t now = time(nullptr);
+    tm local;
+    localtime_r(&now, &local); // localtime usa um buffer estático; o Batch chama begin() de várias threads
+    size_t date_size = strftime(date, sizeof(date), "%B %Y", &local);
+
+    put("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<HighSchoolTimetableArchive>\n"
+        "  <SolutionGroups>\n"
+        "    <SolutionGroup Id=\"");
+    put_escaped(group_id);
+    put("\">\n"
+        "      <MetaData>\n"
+        "        <Contributor>Automated Solution Generator</Contributor>\n"
+        "        <Date>");
+    put(date, date_size);
+    put("</Date>\n"
+        "        <Description>Solution generated programmatically</Description>\n"
+        "      </MetaData>\n");
+    in_group = true;
+}
+
+void SolutionWriter::write(const Instance &instance, const vector<Allocation> &allocations)
+{
+    put("      <Solution Reference=\"");
+    put_escaped(instance.id);
+    put("\">\n"
+        "        <Events>\n");
+
+    for (const Allocation &alloc : allocations)
+    {
+        if (alloc.time_id == Allocation::UNALLOCATED)
+            continue;
+
+        put("          <Event Reference=\"");
+        put_escaped(instance.events[alloc.event_id].id);
+        put("\">\n"
+            "            <Duration>");
+        put_int(alloc.duration);
+        put("</Duration>\n"
+            "            <Time Reference=\"");
+        put_escaped(instance.times[alloc.time_id].id);
+        put("\"/>\n"
+            "          </Event>\n");
+    }
+
+    put("        </Events>\n"
+        "      </Solution>\n");
+}
+
+void SolutionWriter::write(const Instance &instance, const Solution &solution)
+{
+    write(instance, solution.allocations);
+}
+
+void SolutionWriter::finish()
+{
+    if (in_group)
+    {
+        put("    </SolutionGroup>\n"
+            "  </SolutionGroups>\n"
+            "</HighSchoolTimetableArchive>\n");
+        in_group = false;
+    }
+    flush();
+}
@@ -0,0 +1,192 @@
+#include "../include/TabuSearch.h"
+#include "../include/LocalSearch.h"
+
+#include <algorithm>
+
+void TabuSearch::seed(uint64_t value)
+{
+    rng = RngStream(value);
+    greedy.rng = rng.split(0);
+}
+
+bool TabuSearch::best_relocation(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator,
+                                 const Allocation &lesson, int iteration, int current_cost, int best_cost, Candidate &candidate)
+{
+    // Marcadores de aula não alocada só entram se couberem numa aula simples ou dupla
+    if (lesson.duration > 2)
+        return false;
+
+    int event_id = lesson.event_id;
+    uint64_t targets = lesson.duration == 2 ? instance.event_double_times[event_id] : instance.event_single_times[event_id];
+    if (lesson.time_id != Allocation::UNALLOCATED)
+        targets &= ~(1ULL << lesson.time_id);
+    if (targets == 0)
+        return false;
+
+    // Com a aula fora, delta_insert dá o custo exato de cada destino
+    evaluator.apply(solution, {IncrementalEvaluator::Move::REMOVE, lesson});
+    int removed = evaluator.objective() - current_cost;
+
+    int best_time = -1;
+    int best_delta = 0;
+    int ties = 0;
+    for (; targets; targets &= targets - 1)
+    {
+        int time_id = __builtin_ctzll(targets);
+        int delta = removed + evaluator.delta_insert(solution, event_id, time_id, lesson.duration);
+
+        if (is_tabu(event_id, time_id, iteration) && current_cost + delta >= best_cost)
+            continue;
+
+        if (best_time < 0 || delta < best_delta)
+        {
+            best_time = time_id;
+            best_delta = delta;
+            ties = 1;
+        }
+        else if (delta == best_delta && uniform_int_distribution<int>(0, ties++)(rng) == 0)
+        {
+            best_time = time_id;
+        }
+    }
+
+    evaluator.apply(solution, {IncrementalEvaluator::Move::INSERT, lesson});
+
+    if (best_time < 0)
+        return false;
+
+    candidate.from = {lesson};
+    candidate.to = {{event_id, best_time, lesson.duration}};
+    candidate.delta = best_delta;
+    return true;
+}
+
+bool TabuSearch::evaluate_swap(const Instance &instance, Solution &solution, IncrementalEvaluator &evaluator,
+                               const Allocation &a, const Allocation &b, int iteration, int current_cost, int best_cost, Candidate &candidate)
+{
+    if (!LocalSearch::swappable(instance, a, b))
+        return false;
+
+    candidate.from = {a, b};
+    candidate.to = {{a.event_id, b.time_id, a.duration}, {b.event_id, a.time_id, b.duration}};
+
+    // Só mede: a troca é sempre desfeita
+    LocalSearch::exchange(instance, solution, evaluator, candidate.from, candidate.to, [](int)
+                          { return false; }, candidate.delta);
+
+    bool tabu = is_tabu(a.event_id, b.time_id, iteration) || is_tabu(b.event_id, a.time_id, iteration);
+    return !tabu || current_cost + candidate.delta < best_cost;
+}
+
+void TabuSearch::apply(Solution &solution, IncrementalEvaluator &evaluator, const Candidate &candidate, int iteration)
+{
+    for (const Allocation &alloc : candidate.from)
+    {
+        evaluator.apply(solution, {IncrementalEvaluator::Move::REMOVE, alloc});
+
+        if (alloc.time_id != Allocation::UNALLOCATED)
+        {
+            int tenure = min_tenure + uniform_int_distribution<int>(0, max(0, tenure_range - 1))(rng);
+            tabu_until[alloc.event_id * num_times + alloc.time_id] = iteration + tenure;
+        }
+    }
+    for (const Allocation &alloc : candidate.to)
+    {
+        evaluator.apply(solution, {IncrementalEvaluator::Move::INSERT, alloc});
+    }
+}
+
+Solution TabuSearch::solve(Instance &instance, int max_iters, StopCriteria stop)
+{
+    stop.start();
+
+    Solution current_solution = greedy.generate_greedy(instance);
+    IncrementalEvaluator evaluator(instance);
+    evaluator.reset(current_solution);
+
+    int current_cost = evaluator.objective();
+    Solution best_solution = current_solution;
+    int best_cost = current_cost;
+    stop.improved(best_cost);
+
+    num_times = instance.times.size();
+    tabu_until.assign(instance.events.size() * num_times, 0);
+    int last_improvement = 0;
+
+    auto random_index = [&](int n)
+    {
+        return uniform_int_distribution<int>(0, n - 1)(rng);
+    };
+
+    for (int iteration = 0; max_iters < 0 || iteration < max_iters; iteration++)
+    {
+        if (stop.should_stop(best_cost) || current_solution.allocations.empty())
+            break;
+
+        Candidate chosen;
+        bool found = false;
+        int ties = 0;
+
+        auto consider = [&](Candidate &candidate)
+        {
+            if (!found || candidate.delta < chosen.delta)
+            {
+                chosen = candidate;
+                found = true;
+                ties = 1;
+            }
+            else if (candidate.delta == chosen.delta && random_index(++ties) == 0)
+            {
+                chosen = candidate;
+            }
+        };
+
+        // Cópias: avaliar um movimento reordena allocations
+        for (int k = 0; k < relocate_samples; k++)
+        {
+            Allocation lesson = current_solution.allocations[random_index(current_solution.allocations.size())];
+            Candidate candidate;
+            if (best_relocation(instance, current_solution, evaluator, lesson, iteration, current_cost, best_cost, candidate))
+                consider(candidate);
+        }
+
+        for (int k = 0; k < swap_samples; k++)
+        {
+            Allocation a = current_solution.allocations[random_index(current_solution.allocations.size())];
+            const vector<int> &class_events = instance.class_events[instance.events[a.event_id].class_id];
+            const vector<Allocation> &other_lessons = current_solution.event_allocations[class_events[random_index(class_events.size())]];
+            if (other_lessons.empty())
+                continue;
+
+            Allocation b = other_lessons[random_index(other_lessons.size())];
+            Candidate candidate;
+            if (evaluate_swap(instance, current_solution, evaluator, a, b, iteration, current_cost, best_cost, candidate))
+                consider(candidate);
+        }
+
+        if (!found)
+            continue;
+
+        apply(current_solution, evaluator, chosen, iteration);
+        current_cost = evaluator.objective();
+
+        if (current_cost < best_cost)
+        {
+            best_solution = current_solution;
+            best_cost = current_cost;
+            last_improvement = iteration;
+            stop.improved(best_cost);
+        }
+        else if (iteration - last_improvement >= stagnation_limit)
+        {
+            // Estagnou: recomeça da melhor solução com a lista tabu vazia
+            current_solution = best_solution;
+            evaluator.reset(current_solution);
+            current_cost = best_cost;
+            fill(tabu_until.begin(), tabu_until.end(), 0);
+            last_improvement = iteration;
+        }
+    }
+
+    return best_solution;
+}
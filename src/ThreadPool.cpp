@@ -0,0 +1,148 @@
+#include "../include/ThreadPool.h"
+
+ThreadPool::ThreadPool(int num_threads) : ranges(new Range[max(1, num_threads)])
+{
+    for (int id = 1; id < num_threads; id++)
+    {
+        workers.emplace_back(&ThreadPool::worker_loop, this, id);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard<mutex> lock(mtx);
+        stopping = true;
+    }
+    start_cv.notify_all();
+
+    for (thread &t : workers)
+    {
+        t.join();
+    }
+}
+
+int ThreadPool::size() const
+{
+    return workers.size() + 1;
+}
+
+void ThreadPool::parallel_for(int n, const function<void(int, int)> &body)
+{
+    if (n <= 0)
+        return;
+
+    if (workers.empty())
+    {
+        for (int i = 0; i < n; i++)
+        {
+            body(i, 0);
+        }
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock(mtx);
+        job = &body;
+
+        // Faixas contíguas iguais; o desequilíbrio é corrigido pelo roubo
+        int num_ranges = size();
+        for (int w = 0; w < num_ranges; w++)
+        {
+            uint32_t begin = (uint64_t)n * w / num_ranges;
+            uint32_t end = (uint64_t)n * (w + 1) / num_ranges;
+            ranges[w].bounds.store(Range::pack(begin, end));
+        }
+
+        running = workers.size();
+        generation++;
+    }
+    start_cv.notify_all();
+
+    run_job(0);
+
+    unique_lock<mutex> lock(mtx);
+    done_cv.wait(lock, [&]() { return running == 0; });
+    job = nullptr;
+}
+
+void ThreadPool::worker_loop(int worker_id)
+{
+    long long seen = 0;
+    while (true)
+    {
+        {
+            unique_lock<mutex> lock(mtx);
+            start_cv.wait(lock, [&]() { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+        }
+
+        run_job(worker_id);
+
+        {
+            lock_guard<mutex> lock(mtx);
+            running--;
+        }
+        done_cv.notify_one();
+    }
+}
+
+void ThreadPool::run_job(int worker_id)
+{
+    int index;
+    do
+    {
+        while (pop(worker_id, index))
+        {
+            (*job)(index, worker_id);
+        }
+    } while (steal(worker_id));
+}
+
+bool ThreadPool::pop(int worker_id, int &index)
+{
+    Range &own = ranges[worker_id];
+    uint64_t bounds = own.bounds.load();
+    while (true)
+    {
+        uint32_t begin = Range::begin_of(bounds);
+        uint32_t end = Range::end_of(bounds);
+        if (begin >= end)
+            return false;
+
+        if (own.bounds.compare_exchange_weak(bounds, Range::pack(begin + 1, end)))
+        {
+            index = begin;
+            return true;
+        }
+    }
+}
+
+bool ThreadPool::steal(int worker_id)
+{
+    int num_ranges = size();
+    for (int k = 1; k < num_ranges; k++)
+    {
+        Range &victim = ranges[(worker_id + k) % num_ranges];
+        uint64_t bounds = victim.bounds.load();
+        while (true)
+        {
+            uint32_t begin = Range::begin_of(bounds);
+            uint32_t end = Range::end_of(bounds);
+            if (begin >= end)
+                break;
+
+            // Leva a metade final (pelo menos um índice)
+            uint32_t mid = begin + (end - begin) / 2;
+            if (victim.bounds.compare_exchange_weak(bounds, Range::pack(begin, mid)))
+            {
+                // A própria faixa está vazia, então ninguém mais a altera
+                ranges[worker_id].bounds.store(Range::pack(mid, end));
+                return true;
+            }
+        }
+    }
+    return false;
+}
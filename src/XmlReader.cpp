@@ -0,0 +1,369 @@
+#include "../include/XmlReader.h"
+
+#include <cstring>
+#include <cstdlib>
+
+static const size_t CHUNK_SIZE = 64 * 1024;
+
+XmlReader::XmlReader(istream &in) : in(in) {}
+
+bool XmlReader::fill(size_t needed)
+{
+    while (buffer.size() - pos < needed)
+    {
+        if (eof)
+            return false;
+
+        // Descarta o que já foi consumido para manter o buffer limitado
+        if (pos >= CHUNK_SIZE)
+        {
+            buffer.erase(0, pos);
+            pos = 0;
+        }
+
+        size_t old_size = buffer.size();
+        buffer.resize(old_size + CHUNK_SIZE);
+        in.read(&buffer[old_size], CHUNK_SIZE);
+        buffer.resize(old_size + in.gcount());
+        if (in.gcount() == 0)
+            eof = true;
+    }
+    return true;
+}
+
+int XmlReader::peek(size_t offset)
+{
+    if (pos + offset >= buffer.size() && !fill(offset + 1))
+        return -1;
+    return (unsigned char)buffer[pos + offset];
+}
+
+int XmlReader::get()
+{
+    int c = peek();
+    if (c >= 0)
+        pos++;
+    return c;
+}
+
+bool XmlReader::starts_with(const char *s)
+{
+    size_t n = strlen(s);
+    if (!fill(n))
+        return false;
+    return buffer.compare(pos, n, s) == 0;
+}
+
+bool XmlReader::skip_until(const char *terminator)
+{
+    size_t n = strlen(terminator);
+    while (fill(n))
+    {
+        if (buffer.compare(pos, n, terminator) == 0)
+        {
+            pos += n;
+            return true;
+        }
+        pos++;
+    }
+    return false;
+}
+
+void XmlReader::skip_spaces()
+{
+    int c;
+    while ((c = peek()) == ' ' || c == '\n' || c == '\r' || c == '\t')
+    {
+        pos++;
+    }
+}
+
+string XmlReader::read_name()
+{
+    string name;
+    int c;
+    while ((c = peek()) >= 0 && c != ' ' && c != '\n' && c != '\r' && c != '\t' &&
+           c != '>' && c != '/' && c != '=')
+    {
+        name += (char)c;
+        pos++;
+    }
+    return name;
+}
+
+void XmlReader::decode_entity(string &out)
+{
+    // Chamado logo após '&'
+    string entity;
+    int c;
+    while ((c = peek()) >= 0 && c != ';' && entity.size() < 10)
+    {
+        entity += (char)c;
+        pos++;
+    }
+
+    if (c != ';')
+    {
+        out += '&';
+        out += entity;
+        return;
+    }
+    pos++;
+
+    if (entity == "lt")
+        out += '<';
+    else if (entity == "gt")
+        out += '>';
+    else if (entity == "amp")
+        out += '&';
+    else if (entity == "quot")
+        out += '"';
+    else if (entity == "apos")
+        out += '\'';
+    else if (entity.size() > 1 && entity[0] == '#')
+    {
+        unsigned long code = (entity[1] == 'x' || entity[1] == 'X') ? strtoul(entity.c_str() + 2, nullptr, 16)
+                                                                    : strtoul(entity.c_str() + 1, nullptr, 10);
+        // Codifica em UTF-8
+        if (code < 0x80)
+            out += (char)code;
+        else if (code < 0x800)
+        {
+            out += (char)(0xC0 | (code >> 6));
+            out += (char)(0x80 | (code & 0x3F));
+        }
+        else if (code < 0x10000)
+        {
+            out += (char)(0xE0 | (code >> 12));
+            out += (char)(0x80 | ((code >> 6) & 0x3F));
+            out += (char)(0x80 | (code & 0x3F));
+        }
+        else
+        {
+            out += (char)(0xF0 | (code >> 18));
+            out += (char)(0x80 | ((code >> 12) & 0x3F));
+            out += (char)(0x80 | ((code >> 6) & 0x3F));
+            out += (char)(0x80 | (code & 0x3F));
+        }
+    }
+    else
+    {
+        out += '&';
+        out += entity;
+        out += ';';
+    }
+}
+
+bool XmlReader::read_attribute_value(string &value)
+{
+    int quote = get();
+    if (quote != '"' && quote != '\'')
+        return false;
+
+    int c;
+    while ((c = get()) >= 0 && c != quote)
+    {
+        if (c == '&')
+            decode_entity(value);
+        else
+            value += (char)c;
+    }
+    return c == quote;
+}
+
+XmlReader::Token XmlReader::fail()
+{
+    has_error = true;
+    return ERROR;
+}
+
+XmlReader::Token XmlReader::next()
+{
+    if (has_error)
+        return ERROR;
+
+    if (pending_end)
+    {
+        pending_end = false;
+        open_elements.pop_back();
+        current_depth--;
+        return END;
+    }
+
+    while (true)
+    {
+        int c = peek();
+        if (c < 0)
+        {
+            // Arquivo truncado: algum elemento ficou sem fechar
+            if (!open_elements.empty())
+                return fail();
+            return END_OF_FILE;
+        }
+
+        if (c != '<')
+        {
+            // Texto até a próxima tag; trechos só com espaços são ignorados
+            current_text.clear();
+            bool blank = true;
+            while ((c = peek()) >= 0 && c != '<')
+            {
+                pos++;
+                if (c == '&')
+                {
+                    decode_entity(current_text);
+                    blank = false;
+                    continue;
+                }
+                if (c != ' ' && c != '\n' && c != '\r' && c != '\t')
+                    blank = false;
+                current_text += (char)c;
+            }
+            if (blank)
+                continue;
+            return TEXT;
+        }
+
+        if (starts_with("<!--"))
+        {
+            if (!skip_until("-->"))
+                return fail();
+            continue;
+        }
+
+        if (starts_with("<![CDATA["))
+        {
+            pos += 9;
+            current_text.clear();
+            while (!starts_with("]]>"))
+            {
+                int ch = get();
+                if (ch < 0)
+                    return fail();
+                current_text += (char)ch;
+            }
+            pos += 3;
+            return TEXT;
+        }
+
+        if (starts_with("<?"))
+        {
+            if (!skip_until("?>"))
+                return fail();
+            continue;
+        }
+
+        if (starts_with("<!"))
+        {
+            if (!skip_until(">"))
+                return fail();
+            continue;
+        }
+
+        if (starts_with("</"))
+        {
+            pos += 2;
+            current_name = read_name();
+            skip_spaces();
+            if (get() != '>' || open_elements.empty() || open_elements.back() != current_name)
+                return fail();
+            open_elements.pop_back();
+            current_depth--;
+            return END;
+        }
+
+        pos++;
+        current_name = read_name();
+        if (current_name.empty())
+            return fail();
+
+        attributes.clear();
+        while (true)
+        {
+            skip_spaces();
+            c = peek();
+            if (c == '/')
+            {
+                pos++;
+                if (get() != '>')
+                    return fail();
+                pending_end = true;
+                open_elements.push_back(current_name);
+                current_depth++;
+                return START;
+            }
+            if (c == '>')
+            {
+                pos++;
+                open_elements.push_back(current_name);
+                current_depth++;
+                return START;
+            }
+            if (c < 0)
+                return fail();
+
+            string attr_name = read_name();
+            skip_spaces();
+            if (attr_name.empty() || get() != '=')
+                return fail();
+            skip_spaces();
+
+            string value;
+            if (!read_attribute_value(value))
+                return fail();
+            attributes.emplace_back(attr_name, value);
+        }
+    }
+}
+
+const char *XmlReader::attribute(const char *attr_name) const
+{
+    for (const auto &attr : attributes)
+    {
+        if (attr.first == attr_name)
+            return attr.second.c_str();
+    }
+    return nullptr;
+}
+
+bool XmlReader::next_child()
+{
+    while (true)
+    {
+        Token token = next();
+        if (token == START)
+            return true;
+        if (token != TEXT)
+            return false;
+    }
+}
+
+void XmlReader::skip()
+{
+    int target = current_depth - 1;
+    while (true)
+    {
+        Token token = next();
+        if (token == END && current_depth == target)
+            return;
+        if (token == END_OF_FILE || token == ERROR)
+            return;
+    }
+}
+
+string XmlReader::read_text()
+{
+    string out;
+    int target = current_depth - 1;
+    while (true)
+    {
+        Token token = next();
+        if (token == TEXT && current_depth == target + 1)
+            out += current_text;
+        else if (token == END && current_depth == target)
+            break;
+        else if (token == END_OF_FILE || token == ERROR)
+            break;
+    }
+    return out;
+}